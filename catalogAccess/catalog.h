@@ -23,11 +23,13 @@
 //#include <dirent.h>   //for DIR type 
 #include <iomanip>    //for setprecision, _Ios_Fmtflags, ...
 #include <stdexcept>  //for std::runtime_error
+#include <atomic>     //for std::atomic
+#include <functional> //for std::function
+#include <future>     //for std::future
 
 #define MAX_CAT 11              // number of known catalogs
 #define MAX_GEN  6              // number of generic quantities
 #define MAX_URL  9              // number of known VizieR web address
-#define MAX_LINE 1025           // (maximum number of char)+1 with getline
 namespace catalogAccess {
 
 /**
@@ -49,6 +51,7 @@ public:
   Catalog();                    // Default constructor
   ~Catalog();                   // Destructor needed to free memory
   Catalog(const Catalog & );    // Copy constructor needed
+  Catalog& operator=(const Catalog & )=default; // members copy themselves
 
 
   // Methods giving general information
@@ -94,10 +97,25 @@ public:
       // * recognizes catalog name and identifies the files to load
       // * translates the generic quantities
       // * loads non-generic quantities
+      // text (CDS) file can be compressed with gzip or bzip2,
+      // compressed FITS files are read by cfitsio;
+      // VOTable (maybe compressed) with BINARY2 or BINARY stream is read
+      // by blocks, without building its XML document;
       // the method returns the number of loaded rows,
       // -1 if successful import already done, -3 if catName is unknown,
       // other negative number for loading error
 
+  int importFiles(const std::vector<std::string> &fileNames,
+                  const long maxRows=0, const std::string ext="1");
+      // import several files or extensions with the same columns (e.g.
+      // sky region shards) in one catalog: each name can be a glob pattern
+      // ("cat_*.fits") and can end by its own extension ("cat.fits[2]");
+      // files are read concurrently, rows are concatenated in list order,
+      // maxRows limits the total number of rows (0 for all rows): files
+      // are then read one after the other, only until maxRows is reached;
+      // the method returns the number of loaded rows, -5 if columns differ,
+      // other negative number as import()
+
   int importSelected(std::string &filter);
       // if a catalog description was already loaded, this method does
       // the same as import(). However, it applies selection criteria
@@ -107,17 +125,70 @@ public:
       // -1 if successful import already done, -2 if importDescription not done
       // other negative number for loading error      
 
+  typedef std::function<void(long rows, long bytes)> ImportProgress;
+      // called regularly by the thread of an asynchronous import with
+      // the number of rows loaded and bytes of input already read
+      // (uncompressed bytes for text, 0 if unknown as with tip reader)
+  std::future<int> importAsync(const std::string &fileName,
+                   const long maxRows=0, const std::string ext="1",
+                   const ImportProgress progress=ImportProgress());
+  std::future<int> importDescriptionAsync(const std::string &fileName,
+                   const std::string ext="1",
+                   const ImportProgress progress=ImportProgress());
+  std::future<int> importSelectedAsync(std::string &filter,
+                   const ImportProgress progress=ImportProgress());
+      // same as import(), importDescription() and importSelected() in a
+      // second thread: the future gives the result (or the exception);
+      // the catalog (and filter) must not be used until it is ready
+  void cancelImport();
+      // stops the asynchronous import running (if any) which returns -22,
+      // the catalog content is deleted as with deleteContent()
+
+  void setTipReader(const bool useTip=true);
+      // by default, data of FITS BINTABLE are read (and saved) directly
+      // with cfitsio (by blocks of rows); if useTip is true, always read
+      // and write through tip.
+      // tip is anyway used for ASCII TABLE, ROOT or unusual inputs
+  void setTextThreads(const int nbThreads=0);
+      // number of threads parsing data of large text files, and formatting
+      // rows of saveText/saveSelectedText (written in order by one thread):
+      // 0 (default) for one per core, 1 to read and write sequentially
+  void setTextIndex(const long blockLines=0);
+      // if blockLines > 0, import of a text file writes the sidecar
+      // index "fileName.cidx" (offset and range of each column for each
+      // block of blockLines data lines) if it does not exist or does not
+      // match the file size, date and separator; importSelected then
+      // skips the blocks which cannot pass its ANDed cuts (the index does
+      // not give access to rows by number); 0 by default: no index
+  void setFitsSelection(const bool saveSelection=true);
+      // if saveSelection is true, saveFits and saveSelectedFits also write
+      // the selection: criteria as header keywords (SEL*, and S**n for
+      // column n) and bits of each row in a last column SELBITS;
+      // import() of such a table restores the selection without testing
+      // any row (false by default: selection is not saved)
+
   int saveText(const std::string &fileName, bool clobber=false);
       // save the catalog information presently in memory to a text file
+      // (gzip compressed if fileName ends with ".gz")
       // the method returns 1 if successful, negative number otherwise
 
   int saveSelectedText(const std::string &fileName, bool clobber=false);
       // like saveText(), however, storing only the selected rows
       // the method returns 1 if successful, negative number otherwise
 
+  int saveText(const std::string &fileName,
+               const std::vector<std::string> &names, bool clobber=false);
+  int saveSelectedText(const std::string &fileName,
+                       const std::vector<std::string> &names,
+                       bool clobber=false);
+      // like above, however, storing only the quantities given by their
+      // names, in this order (all quantities if names is empty)
+      // the method returns 1 if successful, negative number otherwise
+
   int saveFits(const std::string &fileName, const std::string &extName,
                bool clobber=false, bool append=false);
       // save the catalog information presently in memory to a FITS file
+      // (table tile compressed as by fpack if fileName ends with ".fz")
       // the method returns 1 if successful, negative number otherwise
 
   int saveSelectedFits(const std::string &fileName, const std::string &extName,
@@ -125,6 +196,46 @@ public:
       // like saveFits(), however, storing only the selected rows
       // the method returns 1 if successful, negative number otherwise
 
+  int saveFits(const std::string &fileName, const std::string &extName,
+               const std::vector<std::string> &names,
+               bool clobber=false, bool append=false);
+  int saveSelectedFits(const std::string &fileName, const std::string &extName,
+                       const std::vector<std::string> &names,
+                       bool clobber=false, bool append=false);
+      // like above, however, storing only the quantities given by their
+      // names, in this order (all quantities if names is empty)
+      // the method returns 1 if successful, negative number otherwise
+
+  int appendFits(const std::string &fileName, const std::string &extName="");
+      // add the rows presently in memory after those of the existing
+      // BINTABLE extName (last HDU if empty) of a FITS file, which must have
+      // the same columns (names, types and vector sizes) as the catalog;
+      // only the new rows are written, always with cfitsio
+      // the method returns 1 if successful, negative number otherwise
+
+  int appendSelectedFits(const std::string &fileName,
+                         const std::string &extName="");
+      // like appendFits(), however, adding only the selected rows
+      // the method returns 1 if successful, negative number otherwise
+
+  int saveVOTable(const std::string &fileName, bool clobber=false);
+  int saveSelectedVOTable(const std::string &fileName, bool clobber=false);
+      // save all (or selected) rows in a VOTable 1.3 file with BINARY2
+      // serialization: one FIELD per quantity (name, unit, ucd and comment
+      // as DESCRIPTION), rows written by blocks of base64 lines
+      // the method returns 1 if successful, negative number otherwise
+
+  int saveSnapshot(const std::string &fileName, bool clobber=false,
+                   bool selection=false);
+      // save description, all rows and generic indices in a binary file
+      // (versioned layout, arrays aligned on 8 bytes) for loadSnapshot();
+      // if selection is true, also criteria and selected rows
+      // the method returns 1 if successful, negative number otherwise
+  int loadSnapshot(const std::string &fileName);
+      // same as import() from a file written by saveSnapshot(): file is
+      // mapped in memory and columns are copied without any parsing
+      // the method returns the number of rows, negative number otherwise
+
 
   // Methods for accessing data
   //---------------------------
@@ -150,8 +261,8 @@ public:
   int getSysErrorName(const std::string name, std::string *sysErrName);
       // get the member "sysErrName" of given quantity "name",
       // identifying the systematic error quantity
-/*  int getVecQNames(const std::string name,
-                   std::vector<std::string> *vecNames);*/
+  int getVecQNames(const std::string name,
+                  std::vector<std::string> *vecNames);
       // get the list of the names of the quantities which
       // form the elements of the given VECTOR "name"
 
@@ -170,10 +281,15 @@ public:
   int getNValue(const std::string name, const long row, double *realVal);
       // get the value of the given numerical quantity "name"
       // in the given catalog row
-/*  int getVecValues(const std::string name, const  int row,
-                   std::vector<double> *vecVal);*/
+  int getVecValues(const std::string name, const long row,
+                   std::vector<double> *vecVal);
       // get the values of the given vector quantity "name"
       // in the given catalog row
+  int getVecColumn(const std::string name, const int elem,
+                   const double **first, long *stride);
+      // get (without copy) element "elem" of the given vector quantity:
+      // its value in row i is (*first)[i*stride], valid until the catalog
+      // content changes; with elem=0, row i is (*first)[i*stride+k], k<stride
   int getStatError(const std::string name, const long row, double *realValStat);
       // get the value of the statistical error associated with quantity "name"
       // in the given catalog row;
@@ -182,12 +298,12 @@ public:
       // get the value of the sytematic error associated with quantity "name"
       // in the given catalog row;
       // value is negative if unavailable
-/*  int getVecStatErrors(const std::string name, const long row,
-                       std::vector<double> *vecValStat);*/
+  int getVecStatErrors(const std::string name, const long row,
+                       std::vector<double> *vecValStat);
       // get the statistical errors associated with vector quantity "name"
       // in the given catalog row
-/*  int getVecSysErrors(const std::string name, const long row,
-                      std::vector<double> *vecValSys);*/
+  int getVecSysErrors(const std::string name, const long row,
+                      std::vector<double> *vecValSys);
       // get the systematic errors associated with vector quantity "name"
       // in the given catalog row
 
@@ -212,16 +328,16 @@ public:
   int getSelSValue(const std::string name, const long srow,
                    std::string *stringVal);
   int getSelNValue(const std::string name, const long srow, double *realVal);
-/*  int getSelVecValues(const std::string name, const long srow,
-                      std::vector<double> *vecVal);*/
+  int getSelVecValues(const std::string name, const long srow,
+                      std::vector<double> *vecVal);
   int getSelStatError(const std::string name, const long srow,
                       double *realValStat);
   int getSelSysError(const std::string name, const long srow,
                      double *realValSys);
-/*  int getSelVecStatErrors(const std::string name, const long srow,
+  int getSelVecStatErrors(const std::string name, const long srow,
                           std::vector<double> *vecValStat);
   int getSelVecSysErrors(const std::string name, const long srow,
-                       std::vector<double> *vecValSys);*/
+                         std::vector<double> *vecValSys);
 
   // possible values or range of a given quantity "name" in the selected rows
 
@@ -288,12 +404,12 @@ public:
   int setUpperCut(const std::string name, double cutVal);
       // set and apply a cut on quantity "name" (all values <= cutVal pass)
       // double is not const because it can be locally modified to NO_SEL_CUT
-/*  int setLowerVecCuts(const std::string name,
-                      const std::vector<double> &cutValues);*/
+  int setLowerVecCuts(const std::string name,
+                      const std::vector<double> &cutValues);
       // set and apply a cut on quantities in VECTOR type quantity "name"
       // such that all values >= cutValues[i] pass
-/*  int setUpperVecCuts(const std::string name,
-                      const std::vector<double> &cutValues);*/
+  int setUpperVecCuts(const std::string name,
+                      const std::vector<double> &cutValues);
       // set and apply a cut on quantities in VECTOR type quantity "name"
       // such that all values <= cutValues[i] pass
   int excludeS(const std::string name, const std::vector<std::string> &slist,
@@ -379,6 +495,78 @@ private:
   std::string m_tableRef;
   std::string m_filename; // input file (with extension for fits)
   long        m_filePos;  // position where data start for importSelected()
+  bool        m_useTip;   // if true, FITS data are not read with cfitsio
+  int         m_textThreads; // threads parsing text data, 0: one per core
+  long        m_textIndex;   // data lines per block of text index, 0: none
+  bool        m_fitsSelection; // if true, selection is saved in FITS
+  class AsyncFlag {
+  // atomic flag of the asynchronous import, always false in copied
+  // catalogs (std::atomic alone would delete Catalog::operator=)
+  public:
+    AsyncFlag() : m_flag(false) {}
+    AsyncFlag(const AsyncFlag &) : m_flag(false) {}
+    AsyncFlag& operator=(const AsyncFlag &) { m_flag=false; return *this; }
+    AsyncFlag& operator=(const bool value) { m_flag=value; return *this; }
+    operator bool() const { return m_flag; }
+  private:
+    std::atomic<bool> m_flag;
+  };
+  AsyncFlag      m_async;    // true while an asynchronous import runs
+  AsyncFlag      m_cancel;   // set by cancelImport()
+  ImportProgress m_progress; // callback of the asynchronous import
+
+  class FitsCache {
+  // cfitsio handle kept open between getMaxNumRows, import*
+  // and importSelected; never shared by copied catalogs
+  public:
+    FitsCache() : m_fptr(0), m_time(0), m_size(-1) {}
+    FitsCache(const FitsCache &) : m_fptr(0), m_time(0), m_size(-1) {}
+    FitsCache& operator=(const FitsCache &) { close(); return *this; }
+    ~FitsCache() { close(); }
+    void close();               // close the file if open
+    void *m_fptr;               // fitsfile* positioned on the TABLE
+    std::string m_key;          // fileName+LF+ext as in m_filename
+    long m_time, m_size;        // file modification time and size at open
+  };
+  FitsCache m_fitsCache;
+
+  class TextView : public std::streambuf {
+  // whole text file mapped in memory (copied if it cannot be mapped),
+  // or gzip/bzip2 file uncompressed by blocks in a second thread:
+  // read as stream for the description, then by loadText()
+  public:
+    TextView(const std::string &fileName);
+    ~TextView();
+    bool isOpen() const { return m_ok; }
+    bool isPacked() const { return m_packed != 0; }
+    bool failed() const;        // true if uncompressing failed
+    bool nextLines(const char **begin, const char **end);
+        // gives next data from stream position, made of whole lines
+        // (except at end of file), false at end of file
+    long dataLines(bool *table) const;
+        // lines from stream position (as read by getline) up to the first
+        // one shorter than 2 char or starting with "#Table" (then table is
+        // true), this line included; -1 if file is packed
+    static bool packedText(const std::string &fileName);
+        // true for a gzip or bzip2 file which does not contain FITS
+    const char *m_data;         // first char of file (if not packed)
+    size_t      m_size;         // number of char in file (read if packed)
+    char        m_last;         // last char in file (read if packed)
+    std::string m_name;         // file name
+    long        m_time;         // modification time (0 if unknown)
+  protected:
+    int_type underflow();
+    pos_type seekoff(off_type off, std::ios_base::seekdir way,
+                     std::ios_base::openmode which);
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which);
+  private:
+    TextView(const TextView &); // not copied
+    struct Packed;              // thread and queue of uncompressed blocks
+    bool  m_ok;
+    void *m_map;                // address returned by mmap
+    std::vector<char> m_copy;   // file content when not mapped
+    Packed *m_packed;           // not NULL for compressed file
+  };
   double m_posErrSys;
   double m_posErrFactor;
 
@@ -398,6 +586,13 @@ private:
 
   // comment: the number of numerical quantities == m_numericals.size()
 
+  std::vector<std::vector<double> > m_vectors;
+      // stores all VECTOR contents of the catalog, one flat array per
+      // quantity with a fixed stride n (== m_vectorQs.size()):
+      // m_vectors[2][row*n+k] is element k of VECTOR quantity 2 for row
+
+  // comment: the number of VECTOR quantities == m_vectors.size()
+
   long m_numOriRows;
       // maximal number of rows in CDS catalog
   long m_numRows;
@@ -454,14 +649,22 @@ private:
   bool checkRegion(const long row, const int nRA, const int nDEC);
       // check if given row is inside the elliptical region,
       // nRA and nDEC are the position inside m_numericals.
+  bool inRegion(const double myRA, const double myDEC) const;
+      // check if given position is inside the elliptical region
   bool checkNUM(const double r, const int index, const bool miss,
-                const bool reject, const double precis);
+                const bool reject, const double precis) const;
       // check if value pass criteria for given quantity index (cut AND list)
   bool checkNUMor(const double r, const int index,
-                  const bool reject, const double precis);
+                  const bool reject, const double precis) const;
       // check if value pass criteria for given quantity index (cut OR list)
+  void cutVEC(const int index);
+      // set the bit of given VECTOR quantity index for all rows,
+      // true if all elements pass their cut
   bool rowSelect(const long row, const std::vector<bool> &quantSel);
       // compute the global row selection from bits in m_rowIsSelected
+  void selectedRows(std::vector<long> *rows) const;
+      // indices of the m_numSelRows selected rows, in increasing order
+      // (used by exports to visit only those rows)
   void unsetCuts(const int index);
       // unset cut on quantity found by its existing index
 
@@ -471,45 +674,148 @@ private:
   int doSelN(const std::string name, const int index, const int code,
              const std::vector<double> &listVal);
       // select rows depending on the given numerical list
+  int doCutVec(const std::string origin, const std::string name,
+               const bool isLower, const std::vector<double> &cutValues);
+      // set and apply lower or upper cuts on VECTOR quantity elements
+  int getVecRow(const std::string origin, const int num, const long row,
+                std::vector<double> *vecVal);
+      // copy the elements of VECTOR quantity index at existing row
 
   void setPosErrFactor(const int index);
       // called by setGeneric() to set m_posErrFactor
   void setGeneric(const int whichCat);
       // called just after "import..." to set m_isGeneric, m_index*
   void create_tables(const int nbQuantNum, const long maxRows);
-      // creates a new column in m_strings, m_numericals
+      // creates a new column in m_strings, m_numericals, m_vectors
   void add_rows(const long maxRows);
-      // creates a new row in m_strings, m_numericals
-  void translate_cell(std::string mot, const int index);
-      // loads one quantity at last row (m_numRows);
+      // creates a new row in m_strings, m_numericals, m_vectors
+  void translate_cell(const char *cell, int length, const int index,
+                      const long row,
+                      std::vector<std::vector<double> > &numericals,
+                      std::vector<std::vector<std::string> > &strings) const;
+      // loads one quantity at given row of the tables from a text cell
+      // of given length (cell is not NUL terminated);
+  struct RowFilter;
+  bool init_filter(RowFilter *filter);
+      // ANDed criteria of importSelected which can be checked on each
+      // text row while it is loaded; false if there is none
+  bool passRow(const RowFilter &filter, const long row,
+               const std::vector<std::vector<double> > &numericals,
+               const std::vector<std::vector<std::string> > &strings) const;
+      // true if loaded row passes all criteria of filter
+  int split_row(const char *line, const char *eol, const char *pos,
+                const char sep, const int nbQuant, const bool selected,
+                const long row, std::vector<std::vector<double> > &numericals,
+                std::vector<std::vector<std::string> > &strings,
+                const RowFilter *filter, bool *keep) const;
+      // loads all cells of line (pos is first separator) at given row,
+      // returns 0, 1 if too many cells, -1 if not enough cells;
+      // with a filter, cells with criteria are loaded first and
+      // keep is false (other cells not loaded) if the row fails
+  struct TextIndex;
+  bool readIndex(const TextView &file, const int nbQuant,
+                 TextIndex *index) const;
+      // true if sidecar index of file exists and matches file and catalog
+  void buildIndex(const TextView &file, const char sep, const int nbQuant,
+                  TextIndex *index) const;
+  void writeIndex(const std::string &fileName, const TextIndex &index) const;
+      // index of data blocks computed from file, then written in sidecar
+  bool skipBlock(const TextIndex &index, const long block,
+                 const RowFilter &filter) const;
+      // true if no row of block can pass the criteria of filter
 
   int analyze_fits(const tip::Table *myDOL, const bool getDescr,
                    const std::string origin, long *maxRows);
-  int analyze_head(unsigned long *tot, int *what, bool *testCR, std::fstream*);
+  int readFits(const std::string &fileName, const std::string ext,
+               const std::string &filter, const std::string origin,
+               const int nbQuantNum, long *maxRows);
+      // read the BINTABLE rows passing filter directly with cfitsio,
+      // returns IS_VOID (nothing done) if tip must be used instead
+  bool tipFormat();
+      // true if a quantity format can only be converted by tip
+  bool directFits(const std::string &fileName, const std::string ext);
+      // true if readFits() loads this table without any call to tip
+  bool isFitsCached(const std::string &fileName, const std::string ext);
+      // true if m_fitsCache is open on this table and file is unchanged
+  void *openFits(const std::string &fileName, const std::string ext);
+      // return the fitsfile* of m_fitsCache, opening the table if needed;
+      // NULL if cfitsio cannot open it as TABLE
+  int analyze_head(unsigned long *tot, int *what, bool *testCR, std::istream*);
   int analyze_body(unsigned long *tot, int *what, const bool testCR,
-                   const bool getDescr, std::fstream*, long *maxRows);
+                   const bool getDescr, std::istream*);
       // 3 methods read file for import or importDescription (getDescr=true)
       // returns IS_OK for completion, otherwise strictly negative number
+  int loadText(TextView &file, char sep, const bool selected,
+               unsigned long *tot, long *maxRows);
+      // read the text data rows starting at m_filePos (sep=0 to find it),
+      // only quantities in m_loadQuantity if selected (importSelected);
+      // if *maxRows is 0, tables grow while reading (one pass on file)
+  struct TextChunk;
+  void parseChunk(const char sep, const bool selected,
+                  const RowFilter *filter, const TextIndex *index,
+                  TextChunk *chunk) const;
+  int loadParallel(const char *begin, const char *end, const char sep,
+                   const bool selected, const RowFilter *filter,
+                   const TextIndex *index, const bool grow, int nbChunks,
+                   unsigned long *tot, long *maxRows);
+      // loadText() on newline aligned parts of file parsed in parallel,
+      // then copied in order to the tables with the same warnings
 
   int load(const std::string &fileName, const std::string ext,
            const bool getDescr, long *maxRows);
       // common code between import and importDescription
+  std::future<int> runAsync(const std::function<int()> &load,
+                            const ImportProgress &progress);
+      // common code of the asynchronous imports
+  bool importGoesOn(const long rows, const long bytes) const;
+      // reports progress to callback, false if import is cancelled
+  void init_selection(const std::string origin);
+      // allocates m_rowIsSelected for m_numRows rows, nothing selected
   int loadWeb(const std::string catName, const std::string urlCode,
               const std::string &fileName, const long maxRow);
       // common code between importWeb and importDescriptionWeb
+  int loadSelected(std::string &filter, long maxRows);
+      // code of importSelected(), at most maxRows rows kept if maxRows > 0
   int loadSelectFits(const std::string &fileName, const std::string ext,
                      long *maxRows, std::string &filter);
       // code for fits file importSelected()
-  int loadSelected(unsigned long *tot, std::fstream*, long *maxRows);
-      // code for ASCII file importSelected()
 
+  int exportColumns(const std::string origin,
+                    const std::vector<std::string> &names,
+                    std::vector<int> *cols);
+      // index of the quantities to save (all if names is empty)
   // create catalog header from memory to a text file
   int createText(const std::string &fileName, bool clobber,
-                 const std::string origin);
+                 const std::string origin, const std::vector<int> &cols);
   // create catalog header from memory to a FITS file
   int createFits
      (const std::string &fileName, const std::string &extName, bool clobber,
-      bool append, const std::string origin, tip::Table **ptrTable);
+      bool append, const std::string origin, const std::vector<int> &cols,
+      tip::Table **ptrTable);
+  int writeFits(const std::string &fileName, const std::string &extName,
+                const std::string origin, const std::vector<int> &cols,
+                const bool selected, const bool append, long *tot);
+      // write all (or selected) rows in the table just created by
+      // createFits directly with cfitsio, by blocks of rows; if append
+      // is true, after the rows of the matching table extName
+  int appendRows(const std::string &fileName, const std::string &extName,
+                 const std::string origin, const bool selected);
+      // common code between appendFits and appendSelectedFits
+  int tileFits(const std::string &fileName, const std::string origin);
+      // replace the last HDU of fileName by its tile compressed table
+  int writeSelection(const std::string &fileName, const std::string origin,
+                     const std::vector<int> &cols, const bool selected);
+      // write criteria and selection bits in the last HDU of fileName
+  void readSelection(const std::string origin);
+      // restore the selection saved by writeSelection after import
+  int createVOTable(const std::string &fileName, bool clobber,
+                    const std::string origin, const bool selected);
+      // common code between saveVOTable and saveSelectedVOTable
+  bool votableFile(const std::string &fileName);
+      // true if the file (maybe compressed) starts as an XML document
+  int loadVOTable(const std::string &fileName, const bool getDescr,
+                  const std::string origin, long *maxRows);
+      // description and rows of the first TABLE of a VOTable file
 
   // inline private methods
 
@@ -554,6 +860,12 @@ inline Catalog::Catalog() {
   m_tableRef  ="";
   m_filename  ="";
   m_filePos   =0;
+  m_useTip    =false;
+  m_textThreads=0;
+  m_textIndex=0;
+  m_fitsSelection=false;
+  m_async=false;
+  m_cancel=false;
   m_posErrSys = -1.0;
   m_posErrFactor=1.0;  // "deg" by default
 
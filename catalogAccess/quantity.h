@@ -49,7 +49,7 @@ enum { IS_OK = 1, IS_VOID = 0,
     NO_RA_DEC = -9,
    BAD_ROW = -10, BAD_QUANT_NAME = -11, BAD_QUANT_TYPE = -12, NO_QUANT_ERR= -13,
   BAD_RA = -14, BAD_DEC = -15, BAD_ROT = -16, BAD_AXIS = -17,
- BAD_SEL_LIM = -20, BAD_SEL_QUANT = -21 };
+ BAD_SEL_LIM = -20, BAD_SEL_QUANT = -21, IMPORT_CANCEL = -22 };
 
 extern int verbosity; // global variable 0 (less) to 4 (more verbose)
 extern void printErr(const std::string origin, const std::string text);
@@ -104,8 +104,8 @@ public:
   std::string  m_unit;
       // The unit description, "1" if dimensionless, "" if string
   int m_index;
-      // Where to find the quantity in the m_strings or m_numericals
-      // catalog members array
+      // Where to find the quantity in the m_strings, m_numericals
+      // or m_vectors catalog members array
   bool m_isGeneric;
       // True if the quantity is part of the set of quantities
       // common to all catalogs
@@ -121,6 +121,7 @@ public:
       // If type == VECTOR, this vector of strings contains the ordered list
       // of quantity names which constitute the vector elements.
       // All vector elements have to be numerical quantities.
+      // For a FITS vector column "Flux", names are "Flux[1]" ... "Flux[n]".
       // If type!=VECTOR, vectorQs is empty.
 
 
@@ -139,6 +140,12 @@ public:
   std::vector<double> m_listValN;
      // for string   : undefined; default: empty
      // for numerical: stores the list of values to be tested
+  std::vector<double> m_lowerVecCuts;
+     // for VECTOR   : one minimum value per element (NO_SEL_CUT if no cut)
+     // otherwise    : undefined; default: empty
+  std::vector<double> m_upperVecCuts;
+     // for VECTOR   : one maximum value per element (NO_SEL_CUT if no cut)
+     // otherwise    : undefined; default: empty
 
   bool   m_excludeList;// if false the values in the list lead to row inclusion
   double m_precision;  // test for equality used for m_excludedN, listValN
@@ -164,6 +171,8 @@ inline Quantity::~Quantity() {
   m_vectorQs.clear();
   m_listValS.clear();
   m_listValN.clear();
+  m_lowerVecCuts.clear();
+  m_upperVecCuts.clear();
 }
 
 } // namespace catalogAccess
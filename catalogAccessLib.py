@@ -3,6 +3,10 @@ def generate(env, **kw):
         env.Tool('addLibrary', library = ['catalogAccess'], package = 'catalogAccess')
     env.Tool('st_facilitiesLib')
     env.Tool('tipLib')
+    env.Tool('addLibrary', library = env['cfitsioLibs'])
+    env.Tool('addLibrary', library = ['bz2', 'z'])
+    if env['PLATFORM'] != 'win32':
+        env.AppendUnique(LINKFLAGS = ['-pthread'])
 
 def exists(env):
     return 1
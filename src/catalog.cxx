@@ -12,6 +12,7 @@
  */
 
 #include <cstring>
+#include "fitsio.h"
 #include "catalogAccess/catalog.h"
 
 namespace catalogAccess {
@@ -94,8 +95,21 @@ bool Catalog::existCriteria(std::vector<bool> *quantSel) {
         else quantSel->push_back(false);
       }
 
+      else if (itQ->m_type == Quantity::VECTOR) {
+        // VECTOR quantity are selected by the cuts on its elements
+        unsigned int k, nbV=itQ->m_lowerVecCuts.size();
+        for (k=0; k<nbV; k++) {
+          if ((itQ->m_lowerVecCuts[k] < NO_SEL_CUT) ||
+              (itQ->m_upperVecCuts.at(k) < NO_SEL_CUT)) break;
+        }
+        if (k < nbV) {
+          all=true;
+          quantSel->push_back(true);
+        }
+        else quantSel->push_back(false);
+      }
+
       else quantSel->push_back(false);
-      // VECTOR quantity are selected by the quantities in m_vectorQs
 
     }// loop on quantities
   }
@@ -108,7 +122,7 @@ bool Catalog::existCriteria(std::vector<bool> *quantSel) {
 }
 
 /**********************************************************************/
-// erase m_strings, m_numericals but keep catalog definition
+// erase m_strings, m_numericals, m_vectors but keep catalog definition
 void Catalog::deleteContent() {
 
   int vecSize, i;
@@ -129,6 +143,11 @@ void Catalog::deleteContent() {
     for (i=0; i<vecSize; i++) m_strings[i].clear();
     m_strings.clear();
   }
+  vecSize=m_vectors.size();
+  if (vecSize > 0 ) {
+    for (i=0; i<vecSize; i++) m_vectors[i].clear();
+    m_vectors.clear();
+  }
 }
 /**********************************************************************/
 // erase catalog definition (private method)
@@ -165,7 +184,7 @@ void Catalog::deleteDescription() {
 void Catalog::deleteQuantities() {
 
   unsigned int maxSize=m_loadQuantity.size();
-  int  nbA=0, nbD=0;
+  int  nbA=0, nbD=0, nbV=0;
 
   if (maxSize != m_quantities.size()) {
     printErr("deleteQuantities",
@@ -176,14 +195,15 @@ void Catalog::deleteQuantities() {
   m_rowIsSelected.clear();
   m_numericals.clear();
   m_strings.clear();
+  m_vectors.clear();
 //std::cout << "Initial number of COL = " << maxSize << std::endl;
   std::vector<Quantity>::iterator quantIter;
   quantIter=m_quantities.begin();
   for (unsigned int i=0; i<maxSize; i++) {
     if (m_loadQuantity[i]) {/* change the index in 2D tables */
       if (quantIter->m_type == Quantity::NUM) quantIter->m_index=nbD++;
+      else if (quantIter->m_type == Quantity::VECTOR) quantIter->m_index=nbV++;
       else quantIter->m_index=nbA++;
-      // for the moment, VECTOR considered as STRING
       quantIter++;
     }
     else m_quantities.erase(quantIter);
@@ -213,6 +233,12 @@ Catalog::Catalog(const Catalog & myCat) {
 
   m_filename   =myCat.m_filename;
   m_filePos    =myCat.m_filePos;
+  m_useTip     =myCat.m_useTip;
+  m_textThreads=myCat.m_textThreads;
+  m_textIndex  =myCat.m_textIndex;
+  m_fitsSelection=myCat.m_fitsSelection;
+  m_async      =false;
+  m_cancel     =false;
   m_posErrSys=myCat.m_posErrSys;
   m_posErrFactor=myCat.m_posErrFactor;
 
@@ -322,6 +348,19 @@ Catalog::Catalog(const Catalog & myCat) {
       throw;
     }
   }
+  vecSize=myCat.m_vectors.size();
+  if (vecSize > 0 ) {
+    try {
+      // flat arrays: copy whole content at once
+      m_vectors.resize(vecSize);
+      for (j=0; j<vecSize; j++) m_vectors[j]=myCat.m_vectors[j];
+    }
+    catch (const std::exception &err) {
+      errText=std::string("EXCEPTION on m_vectors[][]: ")+err.what();
+      printErr("Catalog copy constructor", errText);
+      throw;
+    }
+  }
 /* line is commented on purpose to TEMINATE the program on EXCEPTION */
 //} catch (...) { printErr("Catalog copy constructor", ""); }
 }
@@ -365,7 +404,7 @@ void Catalog::getWebList(std::vector<std::string> *names, const bool isCode) {
   std::string text;
   try {
     std::string s;
-    unsigned int pos;
+    std::string::size_type pos;
     for (int i=0; i<MAX_URL; i++) {
       s=Catalog::s_CatalogURL[i]; /* convert C string to C++ string */
       if (isCode) {
@@ -428,30 +467,49 @@ int Catalog::getMaxNumRows(long *nrows, const std::string &fileName,
     return err;
   }*/
   myFile.close();
+  // gzip or bzip2 text
+  bool packed=TextView::packedText(fileName);
+  if ((!m_useTip) && (!packed)) {
+    // one cfitsio open, the table is kept open for the following import
+    fitsfile *fptr=(fitsfile *)openFits(fileName, ext);
+    if (fptr) {
+      i=0;
+      fits_get_num_rows(fptr, nrows, &i);
+      if (!i) {
+        deleteDescription();
+        return IS_OK;
+      }
+      *nrows=0;
+    }
+  }
   std::ostringstream sortie;
   bool  myTest;
   const Extension *myEXT = 0;
-  // cannot use readTable because FITS IMAGE returns also error 1
-  try {
-    myEXT=IFileSvc::instance().readExtension(fileName, ext);
-  }
-  catch (const TipException &x) {
-    err=x.code();
-    if (err == 1) {
-      // This non-cfitsio error number means the file does not exist
-      // or is not a table, or is not in either Root nor Fits format. 
-      err=BAD_FITS;
-/*      printWarn(origin, "FILENAME is NOT fits");*/
+  // compressed text is not given to cfitsio (which uncompresses it)
+  if (packed) err=BAD_FITS;
+  else {
+    // cannot use readTable because FITS IMAGE returns also error 1
+    try {
+      myEXT=IFileSvc::instance().readExtension(fileName, ext);
     }
-    else {
-      // Other errors come from cfitsio, but apply to a file
-      // which is in FITS format but has some sort of format error.
-      sortie << ": FILENAME is FITS, but cfitsio returned error=" << err;
-      printErr(origin, sortie.str());
-      err=BAD_FITS;
-      m_numRows=err;
-      delete myEXT;
-      return err;
+    catch (const TipException &x) {
+      err=x.code();
+      if (err == 1) {
+        // This non-cfitsio error number means the file does not exist
+        // or is not a table, or is not in either Root nor Fits format. 
+        err=BAD_FITS;
+/*        printWarn(origin, "FILENAME is NOT fits");*/
+      }
+      else {
+        // Other errors come from cfitsio, but apply to a file
+        // which is in FITS format but has some sort of format error.
+        sortie << ": FILENAME is FITS, but cfitsio returned error=" << err;
+        printErr(origin, sortie.str());
+        err=BAD_FITS;
+        m_numRows=err;
+        delete myEXT;
+        return err;
+      }
     }
   }
   if (err == IS_OK) myTest=myEXT->isTable();
@@ -489,8 +547,9 @@ int Catalog::getMaxNumRows(long *nrows, const std::string &fileName,
     int what=0;        // 0 for unkwown, >0 for csv, <0 to tsv
                        // fabs()=1 for standard, =2 for meta QUERY
 
-    myFile.open(fileName.c_str(), std::ios::in);
-    err=analyze_head(&tot, &what, &testCR, &myFile);
+    TextView view(fileName);
+    std::istream myText(&view);
+    err=analyze_head(&tot, &what, &testCR, &myText);
     if (!tot) {
       text=": FILENAME \""+fileName+"\" is fits without extension[] specified";
       printErr(origin, text);
@@ -512,34 +571,31 @@ int Catalog::getMaxNumRows(long *nrows, const std::string &fileName,
     }
     else {
       unsigned long refRow=0ul;
-      long maxRows=0l;
       // get columns description and units, data
-      err=analyze_body(&tot, &what, testCR, true, &myFile, &maxRows);
+      err=analyze_body(&tot, &what, testCR, true, &myText);
       // only possible error: found < 4
       if (err == IS_OK) {
         // decription is read until separation line starting with ---
-        char line[MAX_LINE];
-        int  posC,
-             maxLine=MAX_LINE-1; // to avoid computation each line
+        std::string line; // no length limit, capacity kept between lines
         refRow=tot+1;
-        while ( myFile.good() ) {
-          myFile.getline(line, MAX_LINE);
-          tot++;
-          i=strlen(line);
-          if (i < 2) break; // in any case, stop on empty string contrary to
-                            //  load() which continues, skipping lines
-          // string max size is MAX_LINE-1;
-          if (i >= maxLine) {
-            sortie << "line #" << tot << " exceeds maximal size ("
-                   << MAX_LINE << ")";
-            printErr(origin, sortie.str());
+        // file in memory: lines counted without copy
+        bool  table=false;
+        long  nbLines= (myText.good()) ? view.dataLines(&table) : 0;
+        if (nbLines >= 0) {
+          tot+=nbLines;
+          if (table) {
+            sortie << "line #" << tot << ": second table start (not read)";
+            printWarn(origin, sortie.str());
             sortie.str(""); // Will empty the string.
-            err=BAD_FILELINE;
-            break;
           }
-          //if (testCR) line[--i]='\0';
-          posC=strncmp(line, "#Table", 6);
-          if (posC == 0) {
+        }
+        else while ( myText.good() ) {
+          std::getline(myText, line);
+          tot++;
+          // in any case, stop on empty string contrary to
+          // load() which continues, skipping lines
+          if (line.length() < 2) break;
+          if (line.compare(0, 6, "#Table") == 0) {
             // should not happen, normally preceded by empty lines
             sortie << "line #" << tot << ": second table start (not read)";
             printWarn(origin, sortie.str());
@@ -562,7 +618,6 @@ int Catalog::getMaxNumRows(long *nrows, const std::string &fileName,
       sortie << "closing input text file: " << tot << " lines read";
       printLog(0, sortie.str());
     }// analyze_head() is OK
-    myFile.close();
 
   }// file is read
 
@@ -575,7 +630,7 @@ int Catalog::getMaxNumRowsWeb(long *nrows, const std::string catName,
                               const std::string urlCode) {
 
   int i, err;
-  unsigned int pos;
+  std::string::size_type pos;
   std::string web, text, origin="getMaxNumRowsWeb";
   *nrows=0;
   err=BAD_URL;
@@ -772,6 +827,32 @@ int Catalog::getSysErrorName(const std::string name,
   
 /**********************************************************************/
 // get the list of names of the quantities which form the given vector "name"
+int Catalog::getVecQNames(const std::string name,
+                          std::vector<std::string> *vecNames) {
+
+  const std::string origin="getVecQNames";
+  vecNames->clear();
+  int quantSize=checkImport(origin, true);
+  if (quantSize < IS_VOID) return quantSize;
+  quantSize=checkQuant_name(origin, name);
+  if (quantSize < 0) return quantSize;
+  if (m_quantities.at(quantSize).m_type != Quantity::VECTOR) {
+    std::string errText;
+    errText="given Quantity name ("+name+") is not of VECTOR type";
+    printWarn(origin, errText);
+    return BAD_QUANT_TYPE;
+  }
+  try {
+    *vecNames=m_quantities.at(quantSize).m_vectorQs;
+  }
+  catch (const std::exception &err) {
+    std::string errText;
+    errText=std::string("EXCEPTION on vecNames: ")+err.what();
+    printErr(origin, errText);
+    throw;
+  }
+  return IS_OK;
+}
 
 
 
@@ -832,8 +913,78 @@ int Catalog::getNValue(const std::string name, const long row,
   return IS_OK;
 }
 
+/**********************************************************************/
+// copy the elements of given vector quantity index at row (private method)
+int Catalog::getVecRow(const std::string origin, const int num,
+                       const long row, std::vector<double> *vecVal) {
+
+  if (m_quantities.at(num).m_type != Quantity::VECTOR) {
+    std::string errText;
+    errText="given Quantity name ("+m_quantities[num].m_name
+           +") is not of VECTOR type";
+    printWarn(origin, errText);
+    return BAD_QUANT_TYPE;
+  }
+  long nbV=m_quantities[num].m_vectorQs.size();
+  int  index=m_quantities[num].m_index;
+  #ifdef DEBUG_CAT
+    std::cout << "!! DEBUG VECTOR index = " << index << std::endl;
+  #endif
+  if (nbV == 0) return IS_OK;
+  try {
+    std::vector<double>::const_iterator first=m_vectors[index].begin()+row*nbV;
+    vecVal->assign(first, first+nbV);
+  }
+  catch (const std::exception &err) {
+    std::string errText;
+    errText=std::string("EXCEPTION on vecVal: ")+err.what();
+    printErr(origin, errText);
+    throw;
+  }
+  return IS_OK;
+}
 /**********************************************************************/
 // get the values of given vector quantity in given row
+int Catalog::getVecValues(const std::string name, const long row,
+                          std::vector<double> *vecVal) {
+
+  const std::string origin="getVecValues";
+  vecVal->clear();
+  int num=checkSize_row(origin, row);
+  if (num <= IS_VOID) return num;
+  num=checkQuant_name(origin, name);
+  if (num < 0) return num;
+  return getVecRow(origin, num, row, vecVal);
+}
+/**********************************************************************/
+// get without copy one element of given vector quantity for all rows
+int Catalog::getVecColumn(const std::string name, const int elem,
+                          const double **first, long *stride) {
+
+  const std::string origin="getVecColumn";
+  *first=NULL;
+  *stride=0;
+  int num=checkSize_row(origin, 0);
+  if (num <= IS_VOID) return num;
+  num=checkQuant_name(origin, name);
+  if (num < 0) return num;
+  if (m_quantities.at(num).m_type != Quantity::VECTOR) {
+    std::string errText;
+    errText="given Quantity name ("+name+") is not of VECTOR type";
+    printWarn(origin, errText);
+    return BAD_QUANT_TYPE;
+  }
+  int nbV=m_quantities[num].m_vectorQs.size();
+  if ((elem < 0) || (elem >= nbV)) {
+    std::ostringstream sortie;
+    sortie << "VECTOR element must be within [ 0, " << nbV-1 << "]";
+    printWarn(origin, sortie.str());
+    return BAD_QUANT_NAME;
+  }
+  *first=&m_vectors[m_quantities[num].m_index].at(elem);
+  *stride=nbV;
+  return IS_OK;
+}
 
 /**********************************************************************/
 // get the value of the statistical error of given quantity in given row
@@ -890,9 +1041,46 @@ int Catalog::getStatError(const std::string name, const long row,
 
 /**********************************************************************/
 // get the values of the statistical error of given vector in given row
+int Catalog::getVecStatErrors(const std::string name, const long row,
+                              std::vector<double> *vecValStat) {
 
+  const std::string origin="getVecStatErrors";
+  vecValStat->clear();
+  int num=checkSize_row(origin, row);
+  if (num <= IS_VOID) return num;
+  num=checkQuant_name(origin, name);
+  if (num < 0) return num;
+  std::string statName=m_quantities.at(num).m_statError;
+  if (statName.empty()) {
+    statName="given Quantity name ("+name+") has no statistical error";
+    printWarn(origin, statName);
+    return NO_QUANT_ERR;
+  }
+  num=checkQuant_name(origin, statName);
+  if (num < 0) return num;
+  return getVecRow(origin, num, row, vecValStat);
+}
 /**********************************************************************/
 // get the values of the systematic error of given vector in given row
+int Catalog::getVecSysErrors(const std::string name, const long row,
+                             std::vector<double> *vecValSys) {
+
+  const std::string origin="getVecSysErrors";
+  vecValSys->clear();
+  int num=checkSize_row(origin, row);
+  if (num <= IS_VOID) return num;
+  num=checkQuant_name(origin, name);
+  if (num < 0) return num;
+  std::string sysName=m_quantities.at(num).m_sysError;
+  if (sysName.empty()) {
+    sysName="given Quantity name ("+name+") has no systematic error";
+    printWarn(origin, sysName);
+    return NO_QUANT_ERR;
+  }
+  num=checkQuant_name(origin, sysName);
+  if (num < 0) return num;
+  return getVecRow(origin, num, row, vecValSys);
+}
 
 
 /**********************************************************************/
@@ -1067,6 +1255,25 @@ int Catalog::getSelNValue(const std::string name, const long srow,
 
 /**********************************************************************/
 // get the values of given vector quantity in given selected row
+int Catalog::getSelVecValues(const std::string name, const long srow,
+                             std::vector<double> *vecVal) {
+
+  const std::string origin="getSelVecValues";
+  vecVal->clear();
+  int num=checkSel_row(origin, srow);
+  if (num <= IS_VOID) return num;
+  // above test avoid searching for srow when no row is selected
+  num=checkQuant_name(origin, name);
+  if (num < 0) return num;
+  long i, tot=0;
+  // first bit indicates global selection
+  for (i=0; i<m_numRows; i++) if (m_rowIsSelected[0].at(i) & 1) {
+    if (tot == srow) break;
+    tot++;
+  }
+  if (tot < m_numSelRows) return getVecRow(origin, num, i, vecVal);
+  return IS_VOID; // should not happen
+}
 
 /**********************************************************************/
 // get value of the statistical error of given quantity in given selected row
@@ -1136,9 +1343,62 @@ int Catalog::getSelSysError(const std::string name, const long srow,
 }
 /**********************************************************************/
 // get the values of the statistical error of given vector in given selected row
+int Catalog::getSelVecStatErrors(const std::string name, const long srow,
+                                 std::vector<double> *vecValStat) {
 
+  const std::string origin="getSelVecStatErrors";
+  vecValStat->clear();
+  int num=checkSel_row(origin, srow);
+  if (num <= IS_VOID) return num;
+  // above test avoid searching for srow when no row is selected
+  num=checkQuant_name(origin, name);
+  if (num < 0) return num;
+  std::string statName=m_quantities.at(num).m_statError;
+  if (statName.empty()) {
+    statName="given Quantity name ("+name+") has no statistical error";
+    printWarn(origin, statName);
+    return NO_QUANT_ERR;
+  }
+  num=checkQuant_name(origin, statName);
+  if (num < 0) return num;
+  long i, tot=0;
+  // first bit indicates global selection
+  for (i=0; i<m_numRows; i++) if (m_rowIsSelected[0].at(i) & 1) {
+    if (tot == srow) break;
+    tot++;
+  }
+  if (tot < m_numSelRows) return getVecRow(origin, num, i, vecValStat);
+  return IS_VOID; // should not happen
+}
 /**********************************************************************/
 // get the values of the systematic error of given vector in given selected row
+int Catalog::getSelVecSysErrors(const std::string name, const long srow,
+                                std::vector<double> *vecValSys) {
+
+  const std::string origin="getSelVecSysErrors";
+  vecValSys->clear();
+  int num=checkSel_row(origin, srow);
+  if (num <= IS_VOID) return num;
+  // above test avoid searching for srow when no row is selected
+  num=checkQuant_name(origin, name);
+  if (num < 0) return num;
+  std::string sysName=m_quantities.at(num).m_sysError;
+  if (sysName.empty()) {
+    sysName="given Quantity name ("+name+") has no systematic error";
+    printWarn(origin, sysName);
+    return NO_QUANT_ERR;
+  }
+  num=checkQuant_name(origin, sysName);
+  if (num < 0) return num;
+  long i, tot=0;
+  // first bit indicates global selection
+  for (i=0; i<m_numRows; i++) if (m_rowIsSelected[0].at(i) & 1) {
+    if (tot == srow) break;
+    tot++;
+  }
+  if (tot < m_numSelRows) return getVecRow(origin, num, i, vecValSys);
+  return IS_VOID; // should not happen
+}
 
 
 /**********************************************************************/
@@ -11,10 +11,25 @@
  *
  */
 
+#include <cstring>     //for strncpy
+#include <sys/stat.h>  //for stat
+#ifndef WIN32
+#include <glob.h>      //for glob
+#endif
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "fitsio.h"
 #include "catalogAccess/catalog.h"
 
 namespace catalogAccess {
   using namespace tip;
+
+// tip is not thread safe: serialize its use by concurrent imports
+static std::mutex s_tipMutex;
+// layout of the selection saved in a FITS table by writeSelection()
+static const int SEL_VERSION=1;
+static const char SEL_COLUMN[]="SELBITS";
 /**********************************************************************/
 /*  DEFINING CLASS CONSTANTS                                          */
 /**********************************************************************/
@@ -189,6 +204,7 @@ long Catalog::getRAMsize(const long numRows, const bool writeLog) {
       }
     }
     else if (itQ->m_type == Quantity::VECTOR) {
+      nD+=itQ->m_vectorQs.size();
     }
     else { //Quantity::LOGICALS)
       nS++;
@@ -235,11 +251,24 @@ long Catalog::getRAMsize(const long numRows, const bool writeLog) {
 
 
 /**********************************************************************/
-// creates a new column in m_strings, m_numericals (private method)
+// creates a new column in m_strings, m_numericals, m_vectors (private method)
 void Catalog::create_tables(const int nbQuantNum, const long maxRows) {
 
-  int vecSize;
+  int vecSize, nbQuantVec=0;
   std::string errText;
+  std::vector<Quantity>::const_iterator itQ=m_quantities.begin();
+  for (; itQ != m_quantities.end(); ++itQ)
+    if (itQ->m_type == Quantity::VECTOR) nbQuantVec++;
+  if (nbQuantVec > 0) {
+    try {
+      m_vectors.resize(nbQuantVec);
+    }
+    catch (const std::exception &err) {
+      errText=std::string("EXCEPTION on m_vectors: ")+err.what();
+      printErr("private create_tables", errText);
+      throw;
+    }
+  }
   if (nbQuantNum > 0) {
     try {
       m_numericals.resize(nbQuantNum);
@@ -250,7 +279,7 @@ void Catalog::create_tables(const int nbQuantNum, const long maxRows) {
       throw;
     }
   }
-  vecSize=m_quantities.size()-nbQuantNum;
+  vecSize=m_quantities.size()-nbQuantNum-nbQuantVec;
 // printf("sizes = %d , %d\n", nbQuantNum, vecSize);
   if (vecSize > 0) {
     try {
@@ -266,7 +295,7 @@ void Catalog::create_tables(const int nbQuantNum, const long maxRows) {
 
 }
 /**********************************************************************/
-// creates a new row in m_strings, m_numericals (private method)
+// creates a new row in m_strings, m_numericals, m_vectors (private method)
 void Catalog::add_rows(const long maxRows) {
 
   int i, vecSize;
@@ -296,6 +325,20 @@ void Catalog::add_rows(const long maxRows) {
       printErr("private add_rows", errText);
       throw;
     }
+  }
+  if (m_vectors.size() > 0 ) {
+    try {
+      // each VECTOR row has m_vectorQs.size() contiguous elements
+      std::vector<Quantity>::const_iterator itQ=m_quantities.begin();
+      for (; itQ != m_quantities.end(); ++itQ)
+        if (itQ->m_type == Quantity::VECTOR)
+          m_vectors[itQ->m_index].resize(maxRows*itQ->m_vectorQs.size());
+    }
+    catch (const std::exception &err) {
+      errText=std::string("EXCEPTION on m_vectors: ")+err.what();
+      printErr("private add_rows", errText);
+      throw;
+    }
   } 
 
 }
@@ -309,11 +352,12 @@ int Catalog::analyze_fits(const Table *myDOL, const bool getDescr,
   int   i, j, max,
         maxLogSize=0,
         maxVecSize=0,
-        nbQuantNum=0;
+        nbQuantNum=0,
+        nbQuantVec=0;
 /*  char  name[9];  8 char maximum for header key */
   bool  binary=true;
   short test;
-  unsigned int pos;
+  std::string::size_type pos;
   int (*pfunc)(int)=toupper; // function used by transform
   const Header &header=myDOL->getHeader();
 
@@ -410,6 +454,8 @@ int Catalog::analyze_fits(const Table *myDOL, const bool getDescr,
       myCol=myDOL->getColumn(i);
       Quantity readQ;
       readQ.m_name=myCol->getId();
+      // selection bits written by saveFits() are not a quantity
+      if ((binary) && (i == max-1) && (readQ.m_name == SEL_COLUMN)) continue;
       readQ.m_unit=myCol->getUnits();
 //      sprintf(name, "TFORM%d", i+1);
 //      mot=name; /* convert C string to C++ string */
@@ -437,10 +483,22 @@ int Catalog::analyze_fits(const Table *myDOL, const bool getDescr,
             j=atoi(readQ.m_format.c_str());
             colSize[i]=j;
             if (j > maxVecSize) maxVecSize=j;
-            text="skipping FITS TABLE vector";
-            sortie << "VECTOR not supported, unusable column#" << i+1;
-            printWarn(origin, sortie.str() );
-            sortie.str("");
+            /* only fixed size numerical vectors (rB rI rJ rK rE rD) */
+            mot=readQ.m_format.substr(readQ.m_format.length()-1);
+            if ((readQ.m_format.find_first_of("PQ") == std::string::npos)
+                && (mot.find_first_of("BIJKED") == 0)) {
+              for (int k=1; k <= j; k++) {
+                sortie << readQ.m_name << "[" << k << "]";
+                readQ.m_vectorQs.push_back(sortie.str());
+                sortie.str("");
+              }
+            }
+            else {
+              sortie << "VECTOR format " << readQ.m_format
+                     << " not supported, unusable column#" << i+1;
+              printWarn(origin, sortie.str() );
+              sortie.str("");
+            }
           }
         }
         else if ((readQ.m_format[j-1] == 'A') || (readQ.m_format[j-1] == 'L'))
@@ -500,8 +558,11 @@ int Catalog::analyze_fits(const Table *myDOL, const bool getDescr,
         readQ.m_index=nbQuantNum;
         nbQuantNum++;
       }
-      else readQ.m_index=m_quantities.size()-nbQuantNum;
-      // for the moment, VECTOR considered as STRING
+      else if (readQ.m_type == Quantity::VECTOR) {
+        readQ.m_index=nbQuantVec;
+        nbQuantVec++;
+      }
+      else readQ.m_index=m_quantities.size()-nbQuantNum-nbQuantVec;
       try { m_quantities.push_back(readQ); }
       catch (const std::exception &prob) {
         text=std::string("EXCEPTION filling m_quantities: ")+prob.what();
@@ -529,11 +590,24 @@ int Catalog::analyze_fits(const Table *myDOL, const bool getDescr,
 // printf("numRows=%ld\n", m_numOriRows );
   m_numRows=0;
   if ( !*maxRows ) *maxRows=m_numOriRows;
+  // m_filename was set by load() to fileName+LF+ext
+  pos=m_filename.find(0x0A);
+  if ((binary) && (getDescr) && (!m_useTip)) {
+    // keep the table open for importSelected()
+    openFits(m_filename.substr(0, pos), m_filename.substr(pos+1));
+  }
   if ((getDescr) || (m_numOriRows == 0)) return IS_OK;
 
+  if (binary) {
+    j=readFits(m_filename.substr(0, pos), m_filename.substr(pos+1), "",
+               origin, nbQuantNum, maxRows);
+    if (j != IS_VOID) return j;
+  }
   create_tables(nbQuantNum, *maxRows);
   try {
     double rowVal;
+    double *vecVal;
+    int    k, nbV;
 /*when reading a Logical, string gives "T" or "F" while char gives '0' or '1'*/
     std::vector<char>  logic(maxLogSize, ' ');
     std::vector<double> vect(maxVecSize);
@@ -542,6 +616,8 @@ int Catalog::analyze_fits(const Table *myDOL, const bool getDescr,
     // Loop over all records (rows) and extract values
     for (Table::ConstIterator itor=myDOL->begin(); itor != myDOL->end();
          ++itor) {
+      if (((m_numRows & 0xFFF) == 0) && (!importGoesOn(m_numRows, 0)))
+        return IMPORT_CANCEL;
       i=0;
       for (itQ=m_quantities.begin(); itQ != m_quantities.end(); ++itQ, ++i) {
         j=itQ->m_index;
@@ -557,6 +633,23 @@ int Catalog::analyze_fits(const Table *myDOL, const bool getDescr,
         else if (itQ->m_type == Quantity::STRING)
           (*itor)[itQ->m_name].get(m_strings[j].at(m_numRows));
         else if (itQ->m_type == Quantity::VECTOR) {
+          nbV=itQ->m_vectorQs.size();
+          if (nbV == 0) continue; /* unsupported vector format */
+          (*itor)[itQ->m_name].get(vect); // function resizes the vector
+          if (nbV != (int)vect.size()) {
+            text="read vector size differs from expected";
+            printErr(origin, text);
+            throw std::runtime_error(text);
+          }
+          // elements of one row are contiguous, stride is nbV
+          vecVal=&m_vectors[j].at(m_numRows*nbV);
+          if ( itQ->m_null[0]==SepNull ) for (k=0; k < nbV; k++)
+            vecVal[k]=vect[k];
+          else {
+            rowVal=colNull.at(i);
+            for (k=0; k < nbV; k++)
+              vecVal[k]=(vect[k] == rowVal) ? MissNAN : vect[k];
+          }
         }
         else { //Quantity::LOGICALS)
           (*itor)[itQ->m_name].get(logic); // function resizes the vector
@@ -589,6 +682,339 @@ int Catalog::analyze_fits(const Table *myDOL, const bool getDescr,
   return IS_OK;
 }
 /**********************************************************************/
+// choose the library used to read FITS tables
+void Catalog::setTipReader(const bool useTip) {
+
+  m_useTip=useTip;
+}
+/**********************************************************************/
+// choose the number of threads parsing text data
+void Catalog::setTextThreads(const int nbThreads) {
+
+  m_textThreads= (nbThreads < 0) ? 0 : nbThreads;
+}
+/**********************************************************************/
+// choose the number of data lines per block of the text sidecar index
+void Catalog::setTextIndex(const long blockLines) {
+
+  m_textIndex= (blockLines < 0) ? 0 : blockLines;
+}
+/**********************************************************************/
+// choose if the selection is saved in FITS tables
+void Catalog::setFitsSelection(const bool saveSelection) {
+
+  m_fitsSelection=saveSelection;
+}
+/**********************************************************************/
+// close the cfitsio handle kept by the catalog
+void Catalog::FitsCache::close() {
+
+  if (m_fptr) {
+    int status=0;
+    fits_close_file((fitsfile *)m_fptr, &status);
+    m_fptr=0;
+  }
+  m_key="";
+  m_time=0; m_size=-1;
+}
+/**********************************************************************/
+// true if m_fitsCache is open on this table and file is unchanged
+bool Catalog::isFitsCached(const std::string &fileName, const std::string ext) {
+
+  if ( !m_fitsCache.m_fptr ) return false;
+  const char lf = 0x0A;
+  struct stat info;
+  if ((m_fitsCache.m_key == fileName+lf+ext)
+      && (stat(fileName.c_str(), &info) == 0)
+      && (m_fitsCache.m_time == (long)info.st_mtime)
+      && (m_fitsCache.m_size == (long)info.st_size)) return true;
+  // other table or file was modified: no more valid
+  m_fitsCache.close();
+  return false;
+}
+/**********************************************************************/
+// return the cfitsio handle, opening the table if needed (private method)
+void* Catalog::openFits(const std::string &fileName, const std::string ext) {
+
+  if ( isFitsCached(fileName, ext) ) return m_fitsCache.m_fptr;
+  std::string text=fileName;
+  if ( !ext.empty() ) text+='['+ext+']';
+  fitsfile *fptr=0;
+  int  status=0;
+  // ROOT or any error: NULL returned, tip will read or report it
+  if (fits_open_table(&fptr, text.c_str(), READONLY, &status)) return 0;
+  const char lf = 0x0A;
+  struct stat info;
+  m_fitsCache.m_fptr=fptr;
+  m_fitsCache.m_key =fileName+lf+ext;
+  // if stat() fails (e.g. URL), the file will be opened at each call
+  if (stat(fileName.c_str(), &info) == 0) {
+    m_fitsCache.m_time=(long)info.st_mtime;
+    m_fitsCache.m_size=(long)info.st_size;
+  }
+  return fptr;
+}
+/**********************************************************************/
+// true if a quantity format can only be converted by tip (private method)
+bool Catalog::tipFormat() {
+
+  std::string text;
+  int  i, max=m_quantities.size();
+  // complex, bits and variable length columns
+  for (i=0; i<max; i++) {
+    text=m_quantities[i].m_format;
+    if (text.find_first_of("CMXPQ") != std::string::npos) return true;
+  }
+  return false;
+}
+/**********************************************************************/
+// true if readFits() loads this table without any call to tip
+bool Catalog::directFits(const std::string &fileName, const std::string ext) {
+
+  if ((m_useTip) || (tipFormat())) return false;
+  if ( !isFitsCached(fileName, ext) ) return false;
+  int status=0, hdutype=ANY_HDU;
+  fits_get_hdu_type((fitsfile *)m_fitsCache.m_fptr, &hdutype, &status);
+  return ((!status) && (hdutype == BINARY_TBL));
+}
+/**********************************************************************/
+// convert nb raw integers of a FITS column with scale, zero and TNULL;
+// written without branch in loops so that compiler can vectorize them
+template <class T>
+static void convertRaw(const T *raw, const long nb, const bool hasNull,
+                       const T nul, const double scale, const double zero,
+                       double *out) {
+
+  const double nan=MissNAN;
+  long l;
+  if (hasNull) for (l=0; l<nb; l++) {
+    const double x=raw[l]*scale+zero;
+    out[l]=(raw[l] == nul) ? nan : x;
+  }
+  else for (l=0; l<nb; l++) out[l]=raw[l]*scale+zero;
+}
+/**********************************************************************/
+// read nb elements of a numerical column from first row into out:
+// integer columns (B, I, J, K) are read unscaled in the compact buffer raw
+// then converted by whole block, others are converted by cfitsio
+static int readNumCol(fitsfile *fptr, const int colnum, const int type,
+                      const long first, const long nb, const bool hasNull,
+                      const LONGLONG nul, const double scale,
+                      const double zero, std::vector<LONGLONG> &raw,
+                      double *out, int *status) {
+
+  int  anynul;
+  if ((long)raw.size() < nb) raw.resize(nb);
+  void *buf=&raw[0];
+  switch (type) {
+  case TBYTE: {
+    unsigned char noCheck=0;
+    fits_read_col(fptr, TBYTE, colnum, first, 1, nb, &noCheck, buf,
+                  &anynul, status);
+    if (!*status) convertRaw((unsigned char *)buf, nb, hasNull,
+                             (unsigned char)nul, scale, zero, out);
+    break; }
+  case TSHORT: {
+    short noCheck=0;
+    fits_read_col(fptr, TSHORT, colnum, first, 1, nb, &noCheck, buf,
+                  &anynul, status);
+    if (!*status) convertRaw((short *)buf, nb, hasNull, (short)nul,
+                             scale, zero, out);
+    break; }
+  case TLONG: { // 'J' is 32 bits, C long can be 64 bits
+    int noCheck=0;
+    fits_read_col(fptr, TINT, colnum, first, 1, nb, &noCheck, buf,
+                  &anynul, status);
+    if (!*status) convertRaw((int *)buf, nb, hasNull, (int)nul,
+                             scale, zero, out);
+    break; }
+  case TLONGLONG: {
+    LONGLONG noCheck=0;
+    fits_read_col(fptr, TLONGLONG, colnum, first, 1, nb, &noCheck, buf,
+                  &anynul, status);
+    if (!*status) convertRaw((LONGLONG *)buf, nb, hasNull, nul,
+                             scale, zero, out);
+    break; }
+  default: {
+    double dNull=MissNAN;
+    fits_read_col(fptr, TDOUBLE, colnum, first, 1, nb, &dNull, out,
+                  &anynul, status);
+    }
+  }
+  return *status;
+}
+/**********************************************************************/
+// read the BINTABLE rows passing filter directly with cfitsio (private method)
+// m_quantities must be set; each column is read by blocks of rows,
+// undefined values (TNULL or NaN) are converted to MissNAN
+int Catalog::readFits(const std::string &fileName, const std::string ext,
+                      const std::string &filter, const std::string origin,
+                      const int nbQuantNum, long *maxRows) {
+
+  if ((m_useTip) || (tipFormat())) return IS_VOID;
+  std::string text;
+  int  i, max=m_quantities.size();
+  fitsfile *fptr=(fitsfile *)openFits(fileName, ext);
+  if (!fptr) return IS_VOID;
+  int  status=0, hdutype=ANY_HDU;
+  long nrows=0, nbRows=0, nGood;
+  fits_get_hdu_type(fptr, &hdutype, &status);
+  fits_get_num_rows(fptr, &nrows, &status);
+  fits_get_rowsize(fptr, &nbRows, &status);
+  // find the columns of loaded quantities (some can be skipped)
+  char colName[FLEN_VALUE];
+  int  keyStatus=0;
+  long width, rowBytes=0;
+  strcpy(colName, "NAXIS1");
+  fits_read_key(fptr, TLONG, colName, &rowBytes, NULL, &keyStatus);
+  std::vector<int>  colNum(max, 0), colType(max, TDOUBLE);
+  std::vector<long> colRepeat(max, 1);
+  // for integer columns: TNULL, TSCAL, TZERO applied by convertRaw()
+  std::vector<char>     colHasNull(max, 0), colRaw(max, 0);
+  std::vector<LONGLONG> colNull(max, 0);
+  std::vector<double>   colScale(max, 1.0), colZero(max, 0.0);
+  for (i=0; (i<max) && (!status); i++) {
+    strncpy(colName, m_quantities[i].m_name.c_str(), FLEN_VALUE-1);
+    colName[FLEN_VALUE-1]='\0';
+    fits_get_colnum(fptr, CASESEN, colName, &colNum[i], &status);
+    fits_get_coltype(fptr, colNum[i], &colType[i], &colRepeat[i], &width,
+                     &status);
+    if ((m_quantities[i].m_type != Quantity::NUM)
+        && (m_quantities[i].m_type != Quantity::VECTOR)) continue;
+    if ((colType[i] != TBYTE) && (colType[i] != TSHORT)
+        && (colType[i] != TLONG) && (colType[i] != TLONGLONG)) continue;
+    sprintf(colName, "TSCAL%d", colNum[i]);
+    keyStatus=0;
+    fits_read_key(fptr, TDOUBLE, colName, &colScale[i], NULL, &keyStatus);
+    sprintf(colName, "TZERO%d", colNum[i]);
+    keyStatus=0;
+    fits_read_key(fptr, TDOUBLE, colName, &colZero[i], NULL, &keyStatus);
+    sprintf(colName, "TNULL%d", colNum[i]);
+    keyStatus=0;
+    fits_read_key(fptr, TLONGLONG, colName, &colNull[i], NULL, &keyStatus);
+    colHasNull[i]=(keyStatus == 0);
+    colRaw[i]=1;
+    // handle is shared by calls: scaling of the file restored for
+    // the filter, raw integers only set for the block reads below
+    fits_set_tscale(fptr, colNum[i], colScale[i], colZero[i], &status);
+  }
+  // rows passing filter are flagged without copying the table
+  std::vector<char> rowOK;
+  nGood=nrows;
+  if ( !filter.empty() && (!status) && (nrows > 0) ) {
+    std::vector<char> expr(filter.begin(), filter.end());
+    expr.push_back('\0');
+    rowOK.resize(nrows);
+    fits_find_rows(fptr, &expr[0], 1, nrows, &nGood, &rowOK[0], &status);
+  }
+  for (i=0; (i<max) && (!status); i++)
+    if (colRaw[i]) fits_set_tscale(fptr, colNum[i], 1.0, 0.0, &status);
+  if (status || (hdutype != BINARY_TBL)) {
+    // filter syntax error is reported by tip
+    m_fitsCache.close();
+    return IS_VOID;
+  }
+  m_numOriRows=nGood;
+  if ( !*maxRows ) *maxRows=m_numOriRows;
+  if ( !m_numOriRows ) return IS_OK;
+  create_tables(nbQuantNum, *maxRows);
+  if (nbRows < 1) nbRows=1;
+  if (nbRows > nrows) nbRows=nrows;
+
+  std::ostringstream sortie;
+  sortie << "reading fits with cfitsio by blocks of " << nbRows << " rows";
+  printLog(2, sortie.str());
+  sortie.str(""); // Will empty the string.
+  try {
+    int  anynul, j;
+    long k, l, nb, nbV, first=1, last;
+    std::vector<LONGLONG> raw; // raw integers of one block and one column
+    char   lNull=2,     /* logical neither 0 nor 1 */
+           sNull[]="";
+    // buffers (for one block) for string and logical columns
+    long   maxLen=1;
+    for (i=0; i<max; i++) if ((m_quantities[i].m_type == Quantity::STRING)
+         || (m_quantities[i].m_type == Quantity::LOGICALS)) {
+      if (colRepeat[i] > maxLen) maxLen=colRepeat[i];
+    }
+    std::vector<char>   buffer(nbRows*(maxLen+1));
+    std::vector<char *> strPtr(nbRows);
+    for (l=0; l<nbRows; l++) strPtr[l]=&buffer[l*(maxLen+1)];
+
+    while ((first <= nrows) && (m_numRows < *maxRows)) {
+      if (!importGoesOn(m_numRows, (first-1)*rowBytes)) break;
+      // next block of consecutive rows passing filter
+      if ( !rowOK.empty() ) {
+        while ((first <= nrows) && (!rowOK[first-1])) first++;
+        if (first > nrows) break;
+        for (last=first; (last < nrows) && (rowOK[last]); last++);
+        if (last-first >= nbRows) last=first+nbRows-1;
+      }
+      else last=first+nbRows-1;
+      if (last > nrows) last=nrows;
+      nb=last-first+1;
+      if (nb > *maxRows-m_numRows) nb=*maxRows-m_numRows;
+      for (i=0; i<max; i++) {
+        const Quantity &readQ=m_quantities[i];
+        j=readQ.m_index;
+        if (readQ.m_type == Quantity::NUM) {
+          readNumCol(fptr, colNum[i], colType[i], first, nb, colHasNull[i],
+                     colNull[i], colScale[i], colZero[i], raw,
+                     &m_numericals[j][m_numRows], &status);
+        }
+        else if (readQ.m_type == Quantity::VECTOR) {
+          nbV=readQ.m_vectorQs.size();
+          if (nbV == 0) continue; /* unsupported vector format */
+          // elements of consecutive rows are contiguous in file and memory
+          readNumCol(fptr, colNum[i], colType[i], first, nb*nbV,
+                     colHasNull[i], colNull[i], colScale[i], colZero[i], raw,
+                     &m_vectors[j][m_numRows*nbV], &status);
+        }
+        else if (readQ.m_type == Quantity::STRING) {
+          fits_read_col(fptr, TSTRING, colNum[i], first, 1, nb, sNull,
+                        &strPtr[0], &anynul, &status);
+          if (!status) for (l=0; l<nb; l++)
+            m_strings[j][m_numRows+l]=strPtr[l];
+        }
+        else { //Quantity::LOGICALS)
+          nbV=colRepeat[i];
+          fits_read_col(fptr, TLOGICAL, colNum[i], first, 1, nb*nbV, &lNull,
+                        &buffer[0], &anynul, &status);
+          if (!status) for (l=0; l<nb; l++) {
+            text.assign(nbV, ' ');
+            for (k=0; k<nbV; k++) switch (buffer[l*nbV+k]) {
+              case 0: text[k]='F'; break; case 1: text[k]='T'; break;
+              default: break;
+            }
+            m_strings[j][m_numRows+l]=text;
+          }
+        }
+        if (status) break;
+      }
+      if (status) break;
+      m_numRows+=nb;
+      first+=nb;
+    }/* loop on blocks of rows */
+  }
+  catch (const std::exception &prob) {
+    m_fitsCache.close();
+    text=std::string("EXCEPTION reading fits columns: ")+prob.what();
+    printErr(origin, text);
+    throw;
+  }
+  if (status) {
+    char errText[FLEN_ERRMSG];
+    fits_get_errstatus(status, errText);
+    sortie << ": fits EXTENSION, cannot read after row#" << m_numRows+1
+           << " (cfitsio error=" << status << ", " << errText << ")";
+    printErr(origin, sortie.str() );
+    m_fitsCache.close();
+    return BAD_ROW;
+  }
+  if (!importGoesOn(m_numRows, nrows*rowBytes)) return IMPORT_CANCEL;
+  return IS_OK;
+}
+/**********************************************************************/
 /* PRIVATE METHODS analyze_head, analyze_body in file "catalog_ioText.cxx" */
 /**********************************************************************/
 // common code between import and importDescription (private method)
@@ -627,30 +1053,38 @@ int Catalog::load(const std::string &fileName, const std::string ext,
     return err;
   }*/
   myFile.close();
+  // gzip or bzip2 text
+  bool packed=TextView::packedText(fileName);
+  // VOTable (maybe compressed) is read by blocks from its XML text
+  bool votable=votableFile(fileName);
   std::ostringstream sortie;
   bool  myTest;
   const Extension *myEXT = 0;
-  // cannot use readTable because FITS IMAGE returns also error 1
-  try {
-    myEXT=IFileSvc::instance().readExtension(fileName, ext);
-  }
-  catch (const TipException &x) {
-    err=x.code();
-    if (err == 1) {
-      // This non-cfitsio error number means the file does not exist
-      // or is not a table, or is not either Root nor Fits format. 
-      err=BAD_FITS;
-/*      printWarn(origin, "FILENAME is NOT fits");*/
+  // compressed text is not given to cfitsio (which uncompresses it)
+  if ((packed) || (votable)) err=BAD_FITS;
+  else {
+    // cannot use readTable because FITS IMAGE returns also error 1
+    try {
+      myEXT=IFileSvc::instance().readExtension(fileName, ext);
     }
-    else {
-      // Other errors come from cfitsio, but apply to a file
-      // which is in FITS format but has some sort of format error.
-      sortie << ": FILENAME is FITS, but cfitsio returned error=" << err;
-      printErr(origin, sortie.str());
-      err=BAD_FITS;
-      m_numRows=err;
-      delete myEXT;
-      return err;
+    catch (const TipException &x) {
+      err=x.code();
+      if (err == 1) {
+        // This non-cfitsio error number means the file does not exist
+        // or is not a table, or is not either Root nor Fits format. 
+        err=BAD_FITS;
+/*        printWarn(origin, "FILENAME is NOT fits");*/
+      }
+      else {
+        // Other errors come from cfitsio, but apply to a file
+        // which is in FITS format but has some sort of format error.
+        sortie << ": FILENAME is FITS, but cfitsio returned error=" << err;
+        printErr(origin, sortie.str());
+        err=BAD_FITS;
+        m_numRows=err;
+        delete myEXT;
+        return err;
+      }
     }
   }
   if (err == IS_OK) myTest=myEXT->isTable();
@@ -681,6 +1115,17 @@ int Catalog::load(const std::string &fileName, const std::string ext,
     err=analyze_fits(myDOL, getDescr, origin, maxRows);
     delete myDOL;
 
+  }
+  else if (votable) {
+
+    err=loadVOTable(fileName, getDescr, origin, maxRows);
+    if (err == IS_OK) {
+      sortie << "input VOTable file: " << m_numRows << " rows read";
+      printLog(0, sortie.str());
+      sortie.str(""); // Will empty the string.
+    }
+    m_filename=fileName;
+
   }
   else { // (err == BAD_FITS)
 
@@ -690,8 +1135,10 @@ int Catalog::load(const std::string &fileName, const std::string ext,
     int what=0;        // 0 for unkwown, >0 for csv, <0 to tsv
                        // fabs()=1 for standard, =2 for meta QUERY
 
-    myFile.open(fileName.c_str(), std::ios::in);
-    err=analyze_head(&tot, &what, &testCR, &myFile);
+    // file read only once: header as a stream, then data in memory
+    TextView view(fileName);
+    std::istream myText(&view);
+    err=analyze_head(&tot, &what, &testCR, &myText);
     if (!tot) {
       text=": FILENAME \""+fileName+"\" is fits without extension[] specified";
       printErr(origin, text);
@@ -715,20 +1162,20 @@ int Catalog::load(const std::string &fileName, const std::string ext,
       else text="input META file";
 
       // get columns description and units, data
-      err=analyze_body(&tot, &what, testCR, getDescr, &myFile, maxRows);
-      if (err == BAD_FILELINE) {
-        // stopped before reading needed stuff (with getDescr false)
-        text=": FILENAME \""+fileName+"\" couldn't be read (line too long)";
-        printErr(origin, text);
+      err=analyze_body(&tot, &what, testCR, getDescr, &myText);
+      if ((err == IS_OK) && (!getDescr) && (what != 2)) {
+        // what is negative for TSV type
+        char sep=(what > 0) ? ';' : 0x09;
+        err=loadText(view, sep, false, &tot, maxRows);
       }
-      else if (err < IS_OK) {
+      if ((err < IS_OK) && (err != IMPORT_CANCEL)) {
         sortie << ": FILENAME \"" << fileName
              << "\" has wrong type (stopped step " << 5-1*err << ")";
         printErr(origin, sortie.str());
         sortie.str(""); // Will empty the string.
         err=BAD_FILETYPE;
       }
-      else {
+      else if (err != IMPORT_CANCEL) {
         if (what > 0) sortie << text << " is CSV type (; separator)";
         else sortie << text << " is TSV type (Tab=0x09 separator)";
         printLog(1, sortie.str());
@@ -736,7 +1183,6 @@ int Catalog::load(const std::string &fileName, const std::string ext,
       }
 
     }
-    myFile.close();
     sortie << text << ": " << tot << " lines read";
     printLog(0, sortie.str());
     sortie.str(""); // Will empty the string.
@@ -746,7 +1192,7 @@ int Catalog::load(const std::string &fileName, const std::string ext,
   }// file is read
   if (err < 0) {
     deleteContent(); // to erase data already loaded in memory
-    m_numRows=err;
+    if (err != IMPORT_CANCEL) m_numRows=err;
     // exit only if nothing is read
     if ((err == BAD_FILENAME) || (err == BAD_FITS)) return err;
   }
@@ -805,16 +1251,86 @@ int Catalog::import(const std::string &fileName, const long maxRows,
   err=load(fileName, ext, false, &maxR);
   if (err < IS_OK) return err;
   getRAMsize(m_numRows, true);
-  try {
-    if (m_numRows < maxR) {
-      int i;
-      err=m_strings.size();
-      // erase unused memory  printf("ERASING\n");
-      for (i=0; i<err; i++) m_strings[i].resize(m_numRows);
-      err=m_numericals.size();
-      for (i=0; i<err; i++) m_numericals[i].resize(m_numRows);
+  if (m_numRows < maxR) {
+    // erase unused memory  printf("ERASING\n");
+    add_rows(m_numRows);
+  }
+  init_selection("import");
+  readSelection("import");
+  return m_numRows;
+}
+/**********************************************************************/
+// same as import() in a second thread
+std::future<int> Catalog::importAsync(const std::string &fileName,
+                         const long maxRows, const std::string ext,
+                         const ImportProgress progress) {
+
+  return runAsync([this, fileName, maxRows, ext]() {
+                    return import(fileName, maxRows, ext);
+                  }, progress);
+}
+/**********************************************************************/
+// same as importDescription() in a second thread
+std::future<int> Catalog::importDescriptionAsync(const std::string &fileName,
+                         const std::string ext,
+                         const ImportProgress progress) {
+
+  return runAsync([this, fileName, ext]() {
+                    return importDescription(fileName, ext);
+                  }, progress);
+}
+/**********************************************************************/
+// same as importSelected() in a second thread
+std::future<int> Catalog::importSelectedAsync(std::string &filter,
+                         const ImportProgress progress) {
+
+  return runAsync([this, &filter]() { return importSelected(filter); },
+                  progress);
+}
+/**********************************************************************/
+// common code of the asynchronous imports (private method)
+std::future<int> Catalog::runAsync(const std::function<int()> &load,
+                                   const ImportProgress &progress) {
+
+  // set before the thread starts: cancelImport() can be called at once
+  m_cancel=false;
+  m_progress=progress;
+  m_async=true;
+  return std::async(std::launch::async, [this, load]() {
+    int err;
+    try { err=load(); }
+    catch (...) {
+      m_async=false;
+      m_progress=ImportProgress();
+      throw;
     }
-    err=m_quantities.size()+2;
+    m_async=false;
+    m_progress=ImportProgress();
+    if (err == IMPORT_CANCEL)
+      printWarn("cancelImport", "import stopped, catalog content deleted");
+    return err;
+  });
+}
+/**********************************************************************/
+// stop the asynchronous import running
+void Catalog::cancelImport() {
+
+  if (m_async) m_cancel=true;
+}
+/**********************************************************************/
+// called regularly while loading rows (private method)
+bool Catalog::importGoesOn(const long rows, const long bytes) const {
+
+  if (!m_async) return true;
+  if (m_progress) m_progress(rows, bytes);
+  return !m_cancel;
+}
+/**********************************************************************/
+// allocates m_rowIsSelected for m_numRows rows (private method)
+void Catalog::init_selection(const std::string origin) {
+
+  try {
+    int err=m_quantities.size()+2;
     // number of required bits including global and region
     err=1+(err-1)/(sizeof(long)*8);
     m_rowIsSelected.resize(err);
@@ -829,9 +1345,195 @@ int Catalog::import(const std::string &fileName, const long maxRows,
   catch (const std::exception &prob) {
     std::string text;
     text=std::string("EXCEPTION filling m_rowIsSelected: ")+prob.what();
-    printErr("import", text);
+    printErr(origin, text);
     throw;
   }
+}
+/**********************************************************************/
+// import several files having the same columns in one catalog
+int Catalog::importFiles(const std::vector<std::string> &fileNames,
+                         const long maxRows, const std::string ext) {
+
+  const std::string origin="importFiles";
+  std::ostringstream sortie;
+  std::string text;
+  int  err, i, nbFiles;
+  err=checkImport(origin, false);
+  if (err < IS_VOID) return err;
+
+  // list of files: glob patterns expanded, extension after name
+  std::vector<std::string> files, exts;
+  std::vector<std::string>::const_iterator itName;
+  for (itName=fileNames.begin(); itName != fileNames.end(); ++itName) {
+    std::string name=*itName, myExt=ext;
+    int pos=name.length()-1;
+    if ((pos > 0) && (name[pos] == ']')) {
+      pos=name.rfind('[');
+      if (pos > 0) {
+        myExt=name.substr(pos+1, name.length()-pos-2);
+        name.erase(pos);
+      }
+    }
+    #ifndef WIN32
+    glob_t found;
+    if ((name.find_first_of("*?[") != std::string::npos)
+        && (glob(name.c_str(), 0, NULL, &found) == 0)) {
+      for (size_t k=0; k<found.gl_pathc; k++) {
+        files.push_back(found.gl_pathv[k]);
+        exts.push_back(myExt);
+      }
+      globfree(&found);
+      continue;
+    }
+    #endif
+    files.push_back(name);
+    exts.push_back(myExt);
+  }
+  nbFiles=files.size();
+  if (nbFiles == 0) {
+    printErr(origin, ": FILENAME list is EMPTY");
+    m_numRows=BAD_FILENAME;
+    return BAD_FILENAME;
+  }
+  sortie << "importing " << nbFiles << " files";
+  printLog(1, sortie.str());
+  sortie.str(""); // Will empty the string.
+
+  // descriptions are read with tip, one file after the other
+  int level=verbosity; // reset by Catalog constructor
+  std::vector<Catalog> shard(nbFiles);
+  verbosity=level;
+  std::vector<int>     status(nbFiles, IS_VOID);
+  std::vector<char>    alone(nbFiles, 0);
+  int reentrant=fits_is_reentrant();
+  for (i=0; i<nbFiles; i++) {
+    shard[i].m_useTip=m_useTip;
+    // files are already read in parallel (not with a row budget)
+    shard[i].m_textThreads=((nbFiles > 1) && (maxRows <= 0)) ? 1
+                                                             : m_textThreads;
+    status[i]=shard[i].importDescription(files[i], exts[i]);
+    if (status[i] < IS_VOID) break;
+    if (shard[i].m_filename.find(0x0A) != std::string::npos) {
+      // FITS file: in parallel only if tip is not needed
+      alone[i]=((!reentrant) || (!shard[i].directFits(files[i], exts[i])));
+    }
+  }
+  // with maxRows, files are read in list order with the rows still
+  // needed, and not at all once maxRows is reached
+  if ((i == nbFiles) && (maxRows > 0)) {
+    std::string filter;
+    long left=maxRows;
+    for (i=0; (i<nbFiles) && (left > 0); i++) {
+      status[i]=shard[i].loadSelected(filter, left);
+      if (status[i] < IS_VOID) break;
+      left-=shard[i].m_numRows;
+    }
+  }
+  // otherwise data are read concurrently (text and BINTABLE with cfitsio)
+  else if (i == nbFiles) {
+    std::atomic<int> next(0);
+    unsigned int nbThreads=std::thread::hardware_concurrency();
+    if (nbThreads < 1) nbThreads=1;
+    if (nbThreads > (unsigned int)nbFiles) nbThreads=nbFiles;
+    std::vector<std::thread> workers;
+    for (unsigned int t=0; t<nbThreads; t++) workers.push_back(std::thread(
+      [&]() {
+        std::string filter;
+        int k;
+        while ((k=next++) < nbFiles) {
+          if (alone[k]) {
+            std::lock_guard<std::mutex> lock(s_tipMutex);
+            status[k]=shard[k].importSelected(filter);
+          }
+          else status[k]=shard[k].importSelected(filter);
+        }
+      }));
+    for (unsigned int t=0; t<nbThreads; t++) workers[t].join();
+  }
+  // first error in list order and same columns in all files
+  err=IS_OK;
+  for (i=0; i<nbFiles; i++) {
+    if (status[i] < IS_VOID) {
+      err=status[i];
+      text=": FILENAME \""+files[i]+"\" cannot be imported";
+      break;
+    }
+    const std::vector<Quantity> &refQ=shard[0].m_quantities,
+                                &myQ =shard[i].m_quantities;
+    bool same=(refQ.size() == myQ.size());
+    for (unsigned int k=0; (same) && (k < refQ.size()); k++) {
+      same=((refQ[k].m_name == myQ[k].m_name)
+            && (refQ[k].m_type == myQ[k].m_type)
+            && (refQ[k].m_unit == myQ[k].m_unit)
+            && (refQ[k].m_vectorQs.size() == myQ[k].m_vectorQs.size()));
+    }
+    if (!same) {
+      err=BAD_FILETYPE;
+      text=": FILENAME \""+files[i]+"\" columns differ from \""+files[0]+"\"";
+      break;
+    }
+  }
+  if (err < IS_VOID) {
+    printErr(origin, text);
+    m_numRows=err;
+    return err;
+  }
+
+  // description of first file
+  const Catalog &ref=shard[0];
+  m_code      =ref.m_code;
+  m_URL       =ref.m_URL;
+  m_catName   =ref.m_catName;
+  m_catRef    =ref.m_catRef;
+  m_tableName =ref.m_tableName;
+  m_tableRef  =ref.m_tableRef;
+  m_filename  =ref.m_filename;
+  m_filePos   =ref.m_filePos;
+  m_posErrSys   =ref.m_posErrSys;
+  m_posErrFactor=ref.m_posErrFactor;
+  m_quantities  =ref.m_quantities;
+  m_loadQuantity=ref.m_loadQuantity;
+  m_indexErr=ref.m_indexErr;
+  m_indexRA =ref.m_indexRA;
+  m_indexDEC=ref.m_indexDEC;
+  // rows concatenated in list order, each file freed after its copy
+  long total=0, nb;
+  int  nbNum=0, k;
+  m_numOriRows=0;
+  for (i=0; i<nbFiles; i++) {
+    total+=shard[i].m_numRows;
+    m_numOriRows+=shard[i].m_numOriRows;
+  }
+  if ((maxRows > 0) && (total > maxRows)) total=maxRows;
+  for (k=0; k<(int)m_quantities.size(); k++)
+    if (m_quantities[k].m_type == Quantity::NUM) nbNum++;
+  m_numRows=0;
+  create_tables(nbNum, total);
+  for (i=0; (i<nbFiles) && (m_numRows < total); i++) {
+    Catalog &myCat=shard[i];
+    nb=myCat.m_numRows;
+    if (nb > total-m_numRows) nb=total-m_numRows;
+    if (nb <= 0) continue; /* tables may not exist */
+    for (k=0; k<(int)m_numericals.size(); k++)
+      std::copy(myCat.m_numericals[k].begin(),
+                myCat.m_numericals[k].begin()+nb,
+                m_numericals[k].begin()+m_numRows);
+    for (k=0; k<(int)m_strings.size(); k++)
+      std::copy(myCat.m_strings[k].begin(), myCat.m_strings[k].begin()+nb,
+                m_strings[k].begin()+m_numRows);
+    for (k=0; k<(int)m_quantities.size(); k++) {
+      const Quantity &readQ=m_quantities[k];
+      if (readQ.m_type != Quantity::VECTOR) continue;
+      long nbV=readQ.m_vectorQs.size();
+      std::copy(myCat.m_vectors[readQ.m_index].begin(),
+                myCat.m_vectors[readQ.m_index].begin()+nb*nbV,
+                m_vectors[readQ.m_index].begin()+m_numRows*nbV);
+    }
+    m_numRows+=nb;
+    myCat.deleteContent();
+  }
+  getRAMsize(m_numRows, true);
+  init_selection(origin);
   return m_numRows;
 }
 
@@ -938,13 +1640,50 @@ int Catalog::loadSelectFits(const std::string &fileName, const std::string ext,
           if (test) filter+=")";
         }
       }
+      else if (readQ.m_type == Quantity::VECTOR) {
+        /* elements are named NAME[k], all elements with a cut must pass */
+        nbV=readQ.m_vectorQs.size();
+        test=false;
+        for (j=0; j<nbV; j++) {
+          if ((readQ.m_lowerVecCuts.at(j) >= NO_SEL_CUT) &&
+              (readQ.m_upperVecCuts.at(j) >= NO_SEL_CUT)) continue;
+          if (test) filter+=" && ";
+          filter+='(';
+          if (readQ.m_rejectNaN == false)
+            filter+="isnull("+readQ.m_vectorQs[j]+") || ";
+          if (readQ.m_lowerVecCuts[j] < NO_SEL_CUT) {
+            filter+='('+readQ.m_vectorQs[j]+" >= ";
+            sprintf(value, "%.9E", readQ.m_lowerVecCuts[j]);
+            filter+=value; filter+=')';
+            if (readQ.m_upperVecCuts[j] < NO_SEL_CUT) filter+=" && ";
+          }
+          if (readQ.m_upperVecCuts[j] < NO_SEL_CUT) {
+            filter+='('+readQ.m_vectorQs[j]+" <= ";
+            sprintf(value, "%.9E", readQ.m_upperVecCuts[j]);
+            filter+=value; filter+=')';
+          }
+          filter+=')';
+          test=true;
+        }
+      }
       filter+=')';
     }
     if (probCase) printWarn(origin,
       "filter (for binary fits) is NOT case sensitive for string");
   }
+  if ( (!m_useTip) && isFitsCached(fileName, ext) ) {
+    // same unchanged table: columns already checked by import*()
+    int nbNum=0;
+    max=m_quantities.size();
+    for (i=0; i<max; i++) if (m_quantities[i].m_type == Quantity::NUM) nbNum++;
+    m_numRows=0;
+    nbNum=readFits(fileName, ext, filter, origin, nbNum, maxRows);
+    if (nbNum != IS_VOID) return nbNum;
+  }
   try {
-    myDOL=IFileSvc::instance().readTable(fileName, ext, filter);
+    // filter is applied by readFits(), unless tip reader is required
+    if (m_useTip) myDOL=IFileSvc::instance().readTable(fileName, ext, filter);
+    else myDOL=IFileSvc::instance().readTable(fileName, ext);
   }
   catch (const TipException &x) {
     sortie << ": FITS is TABLE, but cfitsio returned error=" << x.code();
@@ -1039,16 +1778,44 @@ int Catalog::loadSelectFits(const std::string &fileName, const std::string ext,
 //std::cout << std::endl;
 //std::cout << m_numOriRows << " OriRows" << std::endl;
   m_numRows=0;
+  if ( !m_useTip ) {
+    int found=readFits(fileName, ext, filter, origin, err, maxRows);
+    if (found != IS_VOID) {
+      delete myDOL;
+      return found;
+    }
+    // cfitsio reader cannot be used: open again with filter for tip
+    delete myDOL;
+    myDOL = 0;
+    try {
+      myDOL=IFileSvc::instance().readTable(fileName, ext, filter);
+      m_numOriRows=myDOL->getNumRecords();
+    }
+    catch (const TipException &x) {
+      sortie << ": FITS is TABLE, but cfitsio returned error=" << x.code();
+      printErr(origin, sortie.str());
+      delete myDOL;
+      return BAD_FITS;
+    }
+  }
   if ( !*maxRows ) *maxRows=m_numOriRows;
-  if ( !m_numOriRows ) return IS_OK;
-
+  if ( !m_numOriRows ) {
+    delete myDOL;
+    return IS_OK;
+  }
   create_tables(err, *maxRows);
   try {
     double rowVal;
+    double *vecVal;
+    unsigned int k, nbV;
     std::vector<char>  logic;
     std::vector<double> vect;
     for (Table::ConstIterator itor=myDOL->begin(); itor != myDOL->end();
          ++itor, ++m_numRows) {
+      if (((m_numRows & 0xFFF) == 0) && (!importGoesOn(m_numRows, 0))) {
+        delete myDOL;
+        return IMPORT_CANCEL;
+      }
       err=0;
       for (itQ=m_quantities.begin(); itQ != m_quantities.end(); ++itQ, ++err) {
         i=itQ->m_index;
@@ -1063,6 +1830,25 @@ int Catalog::loadSelectFits(const std::string &fileName, const std::string ext,
         else if (itQ->m_type == Quantity::STRING)
           (*itor)[itQ->m_name].get(m_strings[i].at(m_numRows) );
         else if (itQ->m_type == Quantity::VECTOR) {
+          nbV=itQ->m_vectorQs.size();
+          if (nbV == 0) continue; /* unsupported vector format */
+          (*itor)[itQ->m_name].get(vect); // function resizes the vector
+          if (nbV != vect.size()) {
+            sortie << ": fits EXTENSION, vector size differs at row#"
+                   << m_numRows+1;
+            printErr(origin, sortie.str() );
+            delete myDOL;
+            return BAD_ROW;
+          }
+          // elements of one row are contiguous, stride is nbV
+          vecVal=&m_vectors[i].at(m_numRows*nbV);
+          if ( itQ->m_null[0]==SepNull ) for (k=0; k < nbV; k++)
+            vecVal[k]=vect[k];
+          else {
+            rowVal=colNull[err];
+            for (k=0; k < nbV; k++)
+              vecVal[k]=(vect[k] == rowVal) ? MissNAN : vect[k];
+          }
         }
         else { //Quantity::LOGICALS)
           (*itor)[itQ->m_name].get(logic); // function resizes the vector
@@ -1088,12 +1874,19 @@ int Catalog::loadSelectFits(const std::string &fileName, const std::string ext,
   return IS_OK;
 }
 /**********************************************************************/
-/* PRIVATE METHOD loadSelected is in file "catalog_ioText.cxx"        */
+/* PRIVATE METHOD loadText is in file "catalog_ioText.cxx"            */
 /**********************************************************************/
 // if a catalog description was already loaded, this method does
 // the same as import() adding selection criteria for loading
 int Catalog::importSelected(std::string &filter) {
 
+  return loadSelected(filter, 0l);
+}
+/**********************************************************************/
+// code of importSelected() keeping at most maxRows rows if maxRows > 0
+// (private method)
+int Catalog::loadSelected(std::string &filter, long maxRows) {
+
   const std::string origin="importSelected";
   int quantSize=checkImport(origin, true);
   if (quantSize < IS_VOID) return quantSize;
@@ -1122,8 +1915,9 @@ int Catalog::importSelected(std::string &filter) {
   }
   err=IS_VOID;
   std::string text;
-  long maxRows=0l;
-  unsigned int pos=m_filename.find(0x0A);
+  // no limit if all rows fit: tables are then sized from m_numOriRows
+  if ((m_numOriRows > 0) && (maxRows >= m_numOriRows)) maxRows=0l;
+  std::string::size_type pos=m_filename.find(0x0A);
   if (pos == std::string::npos) {
 
     if ( m_filename.empty() ) {
@@ -1132,30 +1926,31 @@ int Catalog::importSelected(std::string &filter) {
 
     }
     else {
+      if ( votableFile(m_filename) ) {
+        printErr(origin, "not available for VOTable file, use import()");
+        return BAD_FILETYPE;
+      }
       if (!m_filePos) {
         printErr(origin, "file import was not succesful");
         return IMPORT_NEED;
       }
-      std::fstream myFile (m_filename.c_str(), std::ios::in);
+      TextView view(m_filename);
       // file can be opened ?
-      if ( !myFile.is_open() ) {
+      if ( !view.isOpen() ) {
         text=": FILENAME \""+m_filename+"\" cannot be opened";
         printErr(origin, text);
         err=BAD_FILENAME;
         m_numRows=err;
         return err;
       }
-      // go back to initial position
-      myFile.clear(); // needed to reset flags before seekg
-      myFile.seekg(m_filePos);
       unsigned long tot=0ul; // number of data lines read
-      err=loadSelected(&tot, &myFile, &maxRows);
+      // separator is found on first data line
+      err=loadText(view, 0, true, &tot, &maxRows);
       if (err == IS_OK) {
         sortie << tot << " data lines read for importSelected()";
         printLog(0, sortie.str());
         sortie.str(""); // Will empty the string.
       }
-      myFile.close();
     }
 
   }
@@ -1165,33 +1960,37 @@ int Catalog::importSelected(std::string &filter) {
     std::string fileName=text.substr(0, pos);
     text.erase(0, pos+1);
     const Extension *myEXT = 0;
-    // cannot use readTable because FITS IMAGE returns also error 1
-    try {
-      myEXT=IFileSvc::instance().readExtension(fileName, text);
-    }
-    catch (const TipException &x) {
-      err=x.code();
-      if (err == 1) {
-        // This non-cfitsio error number means the file does not exist
-        // or is not a table, or is not either Root nor Fits format. 
-        sortie << ": FILENAME \"" << fileName;
-        sortie << "\" cannot be opened or is NOT fits";
-        err=BAD_FILENAME;
+    // same table still open and unchanged: already known as TABLE
+    if ( (!m_useTip) && isFitsCached(fileName, text) ) err=IS_OK;
+    else {
+      // cannot use readTable because FITS IMAGE returns also error 1
+      try {
+        myEXT=IFileSvc::instance().readExtension(fileName, text);
       }
-      else {
-        // Other errors come from cfitsio, but apply to a file
-        // which is in FITS format but has some sort of format error.
-        sortie << ": FILENAME is FITS, but cfitsio returned error=" << err;
-        err=BAD_FITS;
+      catch (const TipException &x) {
+        err=x.code();
+        if (err == 1) {
+          // This non-cfitsio error number means the file does not exist
+          // or is not a table, or is not either Root nor Fits format. 
+          sortie << ": FILENAME \"" << fileName;
+          sortie << "\" cannot be opened or is NOT fits";
+          err=BAD_FILENAME;
+        }
+        else {
+          // Other errors come from cfitsio, but apply to a file
+          // which is in FITS format but has some sort of format error.
+          sortie << ": FILENAME is FITS, but cfitsio returned error=" << err;
+          err=BAD_FITS;
+        }
       }
-    }
-    if (err >= IS_VOID) {
-      if ( !myEXT->isTable() ) {
-        sortie << ": FILENAME is FITS, but NOT a TABLE";
-        err=BAD_FITS;
+      if (err >= IS_VOID) {
+        if ( !myEXT->isTable() ) {
+          sortie << ": FILENAME is FITS, but NOT a TABLE";
+          err=BAD_FITS;
+        }
       }
+      delete myEXT;
     }
-    delete myEXT;
     if (err < IS_VOID) {
       printErr(origin, sortie.str());
       m_numRows=err;
@@ -1202,16 +2001,13 @@ int Catalog::importSelected(std::string &filter) {
   }
   if (err < IS_VOID) {
     deleteContent(); // to erase data already loaded in memory
-    m_numRows=err;
+    if (err != IMPORT_CANCEL) m_numRows=err;
     return err;
   }
   try {
     if (m_numRows < maxRows) {
-      err=m_strings.size();
       // erase unused memory  printf("ERASING\n")
-      for (i=0; i<err; i++) m_strings[i].resize(m_numRows);
-      err=m_numericals.size();
-      for (i=0; i<err; i++) m_numericals[i].resize(m_numRows);
+      add_rows(m_numRows);
     }
     err=m_quantities.size()+2;
     // number of required bits including global and region
@@ -1269,6 +2065,7 @@ int Catalog::importSelected(std::string &filter) {
                   m_rowIsSelected[k].at(maxRows)&= (Max_Test-quantBit);
               }
             }
+            else if (readQ.m_type == Quantity::VECTOR) cutVEC(i-1);
             else { // numerical quantity, VECTOR cannot exist in string data
               j=i-1;
               nbV=readQ.m_index;
@@ -1331,7 +2128,9 @@ int Catalog::importSelected(std::string &filter) {
             }
           }/* loop on rows */
         }
-        eraseNonSelected();
+        // text rows failing ANDed criteria are not loaded
+        if ((m_numSelRows < m_numRows) || (pos != std::string::npos))
+          eraseNonSelected();
 
       }
       else  // lines can be commented to test the try catch mechanism
@@ -1349,10 +2148,39 @@ int Catalog::importSelected(std::string &filter) {
 
 
 /**********************************************************************/
-// create catalog header from memory to a FITS file
+// index of the exported quantities from their names, all if names
+// is empty (private method)
+int Catalog::exportColumns(const std::string origin,
+                           const std::vector<std::string> &names,
+                           std::vector<int> *cols) {
+
+  int i, err=checkImport(origin, true);
+  if (err < IS_VOID) return err;
+
+  cols->clear();
+  if (names.empty()) {
+    for (i=0; i<(int)m_quantities.size(); i++) cols->push_back(i);
+    return IS_OK;
+  }
+  std::vector<char> used(m_quantities.size(), 0);
+  for (const std::string &name : names) {
+    i=checkQuant_name(origin, name);
+    if (i < 0) return i;
+    if (used[i]) {
+      printErr(origin, ": Quantity name ("+name+") given twice");
+      return BAD_QUANT_NAME;
+    }
+    used[i]=1;
+    cols->push_back(i);
+  }
+  return IS_OK;
+}
+/**********************************************************************/
+// create catalog header from memory to a FITS file, with the
+// quantities of index cols only (in this order)
 int Catalog::createFits(const std::string &fileName, const std::string &extName,
                         bool clobber, bool append, const std::string origin,
-                        tip::Table **ptrTable) {
+                        const std::vector<int> &cols, tip::Table **ptrTable) {
 
 /*  char name[9];  8 char maximum for header key */
   std::string text, newName;
@@ -1439,12 +2267,12 @@ UNUSBALE, otherwise append of long comment done after EXTNAME
     printWarn(origin, text);
   }
   try {
-    unsigned int pos;
+    std::string::size_type pos;
     IColumn *myCol = 0;
 
-    err=m_quantities.size();
+    err=cols.size();
     for (j=0; j < err; j++) {
-      const Quantity &readQ=m_quantities[j];
+      const Quantity &readQ=m_quantities[cols[j]];
       text=readQ.m_format; // from binary: same format
       if ( !m_URL.empty() ) {
         /* from ASCII: Iw or Fw.d or Ew.d or Dw.d (Aw for string) */
@@ -1462,19 +2290,19 @@ UNUSBALE, otherwise append of long comment done after EXTNAME
       text=readQ.m_null;
       if ( !text.empty() ) {
         if ( text[0]!=SepNull ) {
-          myCol->getColumnKeyword("TNULL").set( atoi(text.c_str()) );
+          myCol->getColumnKeyword("TNULL").set( atol(text.c_str()) );
           myCol->getColumnKeyword("TNULL").setComment("Undefined value of field");
         }
         pos=text.find(SepNull); /* always exist */
         text.erase(0, pos+1);
         pos=text.find(SepNull); /* always exist */
         if (pos > 0) {
-          myCol->getColumnKeyword("TSCAL").set( atoi(text.c_str()) );
+          myCol->getColumnKeyword("TSCAL").set( atof(text.c_str()) );
           myCol->getColumnKeyword("TSCAL").setComment("to rescale data");
         }
         text.erase(0, pos+1);
         if ( !text.empty() ) {
-          myCol->getColumnKeyword("TZERO").set( atoi(text.c_str()) );
+          myCol->getColumnKeyword("TZERO").set( atof(text.c_str()) );
           myCol->getColumnKeyword("TZERO").setComment("offset for unsigned integers");
         }
       }
@@ -1509,40 +2337,704 @@ printf("%s\n", itor->getName().c_str() );
   return IS_OK;
 }
 /**********************************************************************/
+// physical value of TNULL (rescaled by TSCAL and TZERO, as when read)
+// from Quantity::m_null; false if the column has no TNULL
+static bool nullValue(const std::string &null, double *value) {
+
+  *value=0.;
+  if ((null.empty()) || (null[0] == SepNull)) return false;
+  std::string::size_type pos=null.find(SepNull), next;
+  *value=atof(null.c_str());
+  if (pos == std::string::npos) return true;
+  next=null.find(SepNull, pos+1);
+  if (next == std::string::npos) next=null.size();
+  if (next > pos+1) *value*=atof(null.substr(pos+1, next-pos-1).c_str());
+  if (next+1 < null.size()) *value+=atof(null.c_str()+next+1);
+  return true;
+}
+/**********************************************************************/
+// replace NaN by the TNULL value of an integer column;
+// written without branch (x != x only for NaN) to be vectorized
+static void nullNaN(double *values, const long nb, const double nul) {
+
+  for (long l=0; l<nb; l++) values[l]= (values[l] != values[l]) ? nul
+                                                                 : values[l];
+}
+/**********************************************************************/
+// write all (or selected) rows in the table created by createFits
+// directly with cfitsio, by blocks of rows and column after column
+// (private method); the rows must already be allocated unless append
+// is true: rows are then added after those of the table extName (the
+// last HDU if empty) which must have the same columns; column i+1
+// of the table holds the quantity of index cols[i]
+int Catalog::writeFits(const std::string &fileName, const std::string &extName,
+                       const std::string origin, const std::vector<int> &cols,
+                       const bool selected, const bool append, long *tot) {
+
+  std::ostringstream sortie;
+  int  i, j, max=cols.size();
+  long l, nb, nbV, maxV=1, first,
+       nbRows=0, nrows= selected ? m_numSelRows : m_numRows;
+  LONGLONG oldRows=0;
+  *tot=0;
+  // a READONLY handle on the same file must not be shared
+  const char lf = 0x0A;
+  if (m_fitsCache.m_key.compare(0, fileName.length()+1, fileName+lf) == 0)
+    m_fitsCache.close();
+
+  fitsfile *fptr=0;
+  int  status=0, hdutype=ANY_HDU, nbHdu=0;
+  fits_open_file(&fptr, fileName.c_str(), READWRITE, &status);
+  if ( extName.empty() ) {
+    // createFits() appended the table after all other HDUs
+    fits_get_num_hdus(fptr, &nbHdu, &status);
+    fits_movabs_hdu(fptr, nbHdu, &hdutype, &status);
+  }
+  else {
+    fits_movnam_hdu(fptr, BINARY_TBL, const_cast<char *>(extName.c_str()),
+                    0, &status);
+    fits_get_hdu_type(fptr, &hdutype, &status);
+  }
+  fits_get_rowsize(fptr, &nbRows, &status);
+  if (status || (hdutype != BINARY_TBL)) {
+    if (fptr) {
+      int closeStatus=0;
+      fits_close_file(fptr, &closeStatus);
+    }
+    sortie << ": fits EXTENSION, cannot be opened by cfitsio (error="
+           << status << ")";
+    printErr(origin, sortie.str() );
+    return BAD_FITS;
+  }
+  if (nbRows < 1) nbRows=1;
+  if (nbRows > nrows) nbRows=nrows;
+
+  // numerical values are copied block by block: NaN are replaced
+  // by TNULL in the copy, as done before cell by cell
+  std::vector<double> colNull(max, 0.);
+  std::vector<char>   hasNull(max, 0);
+  for (i=0; i<max; i++) {
+    const Quantity &readQ=m_quantities[cols[i]];
+    hasNull[i]=nullValue(readQ.m_null, &colNull[i]);
+    if (readQ.m_type == Quantity::VECTOR) {
+      nbV=readQ.m_vectorQs.size();
+      if (nbV > maxV) maxV=nbV;
+    }
+  }
+  if (append) {
+    // same number, names and types of columns (TNULL is taken from file)
+    char  name[FLEN_VALUE], keyName[FLEN_KEYWORD];
+    int   nbCols=0, typecode=0, zTable=0;
+    long  repeat=0, width=0;
+    LONGLONG nul=0;
+    double scale, zero;
+    fits_read_key(fptr, TLOGICAL, const_cast<char *>("ZTABLE"), &zTable, NULL,
+                  &status);
+    if (status == KEY_NO_EXIST) { status=0; zTable=0; }
+    fits_get_num_cols(fptr, &nbCols, &status);
+    fits_get_num_rowsll(fptr, &oldRows, &status);
+    if ((zTable) || (nbCols != max)) i=-1;
+    else for (i=0; (i<max) && (!status); i++) {
+      const Quantity &readQ=m_quantities[cols[i]];
+      sprintf(keyName, "TTYPE%d", i+1);
+      fits_read_key(fptr, TSTRING, keyName, name, NULL, &status);
+      fits_get_coltype(fptr, i+1, &typecode, &repeat, &width, &status);
+      if ((status) || (readQ.m_name != name)) break;
+      if (readQ.m_type == Quantity::STRING) {
+        if (typecode != TSTRING) break;
+      }
+      else if ((typecode <= TBIT) || (typecode == TLOGICAL)
+               || (typecode == TSTRING) || (typecode == TCOMPLEX)
+               || (typecode == TDBLCOMPLEX)) break;
+      else if (readQ.m_type == Quantity::NUM) {
+        if (repeat != 1) break;
+      }
+      else if (repeat != (long)readQ.m_vectorQs.size()) break;
+      sprintf(keyName, "TNULL%d", i+1);
+      fits_read_key(fptr, TLONGLONG, keyName, &nul, NULL, &status);
+      hasNull[i]=(status == 0);
+      if (status == KEY_NO_EXIST) status=0;
+      // values written are rescaled by cfitsio with TSCAL, TZERO of file
+      scale=1.; zero=0.;
+      sprintf(keyName, "TSCAL%d", i+1);
+      fits_read_key(fptr, TDOUBLE, keyName, &scale, NULL, &status);
+      if (status == KEY_NO_EXIST) status=0;
+      sprintf(keyName, "TZERO%d", i+1);
+      fits_read_key(fptr, TDOUBLE, keyName, &zero, NULL, &status);
+      if (status == KEY_NO_EXIST) status=0;
+      colNull[i]=nul*scale+zero;
+    }
+    if ((status) || (i != max)) {
+      int closeStatus=0;
+      fits_close_file(fptr, &closeStatus);
+      if (status) sortie << ": fits EXTENSION, cannot read columns (error="
+                         << status << ")";
+      else if (zTable) sortie << ": fits EXTENSION, tile compressed table "
+                              << "cannot be appended";
+      else if (i < 0) sortie << ": fits EXTENSION, " << nbCols
+                              << " columns instead of " << max;
+      else sortie << ": fits EXTENSION, column#" << i+1 << " does not match '"
+                  << m_quantities[cols[i]].m_name << "'";
+      printErr(origin, sortie.str() );
+      return BAD_FITS;
+    }
+    // all rows added at once, the following HDUs are moved only once
+    if (nrows > 0) fits_insert_rows(fptr, oldRows, nrows, &status);
+    if (status) {
+      char errText[FLEN_ERRMSG];
+      int  closeStatus=0;
+      fits_get_errstatus(status, errText);
+      fits_close_file(fptr, &closeStatus);
+      sortie << ": fits EXTENSION, cannot add " << nrows
+             << " rows (cfitsio error=" << status << ", " << errText << ")";
+      printErr(origin, sortie.str() );
+      return BAD_ROW;
+    }
+  }
+  try {
+    // index of the written rows when only selected are saved
+    std::vector<long> rows;
+    if ((selected) && (nrows < m_numRows)) selectedRows(&rows);
+    std::vector<double> block(nbRows*maxV);
+    std::vector<char *> strPtr(nbRows);
+
+    for (first=0; (first < nrows) && (!status); first+=nb) {
+      nb=nrows-first;
+      if (nb > nbRows) nb=nbRows;
+      for (i=0; (i<max) && (!status); i++) {
+        const Quantity &readQ=m_quantities[cols[i]];
+        j=readQ.m_index;
+        if (readQ.m_type == Quantity::NUM) {
+          const double *in=&m_numericals[j][0];
+          if (rows.empty()) std::copy(in+first, in+first+nb, &block[0]);
+          else for (l=0; l<nb; l++) block[l]=in[rows[first+l]];
+          if (hasNull[i]) nullNaN(&block[0], nb, colNull[i]);
+          fits_write_col(fptr, TDOUBLE, i+1, oldRows+first+1, 1, nb,
+                         &block[0], &status);
+        }
+        else if (readQ.m_type == Quantity::STRING) {
+          for (l=0; l<nb; l++) {
+            const std::string &word=m_strings[j][rows.empty() ? first+l
+                                                       : rows[first+l]];
+            strPtr[l]=const_cast<char *>(word.c_str());
+          }
+          fits_write_col(fptr, TSTRING, i+1, oldRows+first+1, 1, nb,
+                         &strPtr[0], &status);
+        }
+        else if (readQ.m_type == Quantity::VECTOR) {
+          nbV=readQ.m_vectorQs.size();
+          if (nbV == 0) continue; /* unsupported vector format */
+          // elements of consecutive rows are contiguous in file and memory
+          const double *in=&m_vectors[j][0];
+          if (rows.empty())
+            std::copy(in+first*nbV, in+(first+nb)*nbV, &block[0]);
+          else for (l=0; l<nb; l++)
+            std::copy(in+rows[first+l]*nbV, in+(rows[first+l]+1)*nbV,
+                      &block[l*nbV]);
+          if (hasNull[i]) nullNaN(&block[0], nb*nbV, colNull[i]);
+          fits_write_col(fptr, TDOUBLE, i+1, oldRows+first+1, 1, nb*nbV,
+                         &block[0], &status);
+        }
+      }
+      if (!status) *tot+=nb;
+    }/* loop on blocks of rows */
+  }
+  catch (const std::exception &prob) {
+    int closeStatus=0;
+    fits_close_file(fptr, &closeStatus);
+    sortie << "EXCEPTION writing fits columns: " << prob.what();
+    printErr(origin, sortie.str() );
+    throw;
+  }
+  if (status) {
+    char errText[FLEN_ERRMSG];
+    int  closeStatus=0;
+    fits_get_errstatus(status, errText);
+    // existing rows of the table are kept, added ones removed
+    if ((append) && (nrows > 0)) {
+      fits_delete_rows(fptr, oldRows+1, nrows, &closeStatus);
+      closeStatus=0;
+    }
+    fits_close_file(fptr, &closeStatus);
+    sortie << ": fits EXTENSION, cannot write at row#" << *tot
+           << " (cfitsio error=" << status << ", " << errText << ")";
+    printErr(origin, sortie.str() );
+    return BAD_ROW;
+  }
+  fits_close_file(fptr, &status);
+  if (status) {
+    sortie << ": fits EXTENSION, cannot be closed (cfitsio error="
+           << status << ")";
+    printErr(origin, sortie.str() );
+    return BAD_FITS;
+  }
+  return IS_OK;
+}
+/**********************************************************************/
+// replace the last HDU of fileName (written by saveFits) by the same
+// table tile compressed; other HDUs are copied unchanged (private method)
+int Catalog::tileFits(const std::string &fileName, const std::string origin) {
+
+  std::ostringstream sortie;
+  const std::string tmpName=fileName+".tmp";
+  fitsfile *in=0, *out=0;
+  int  i, nbHdu=0, hdutype, status=0, closeStatus=0;
+  remove(tmpName.c_str());
+  fits_open_file(&in, fileName.c_str(), READONLY, &status);
+  fits_get_num_hdus(in, &nbHdu, &status);
+  fits_create_file(&out, tmpName.c_str(), &status);
+  for (i=1; (i<nbHdu) && (!status); i++) {
+    fits_movabs_hdu(in, i, &hdutype, &status);
+    fits_copy_hdu(in, out, 0, &status);
+  }
+  fits_movabs_hdu(in, nbHdu, &hdutype, &status);
+  fits_compress_table(in, out, &status);
+  if (out) fits_close_file(out, &closeStatus);
+  if (!status) status=closeStatus;
+  closeStatus=0;
+  if (in) fits_close_file(in, &closeStatus);
+  if ((!status) && (rename(tmpName.c_str(), fileName.c_str()) != 0))
+    status=FILE_NOT_CREATED;
+  if (status) {
+    char errText[FLEN_ERRMSG];
+    fits_get_errstatus(status, errText);
+    remove(tmpName.c_str());
+    sortie << ": fits EXTENSION, cannot be tile compressed (cfitsio error="
+           << status << ", " << errText << "), file left uncompressed";
+    printErr(origin, sortie.str() );
+    return BAD_FITS;
+  }
+  return IS_OK;
+}
+/**********************************************************************/
+// list of numbers (exact round trip) or of strings ("size:chars" each,
+// ended by ';' as trailing blanks of FITS strings are not significant)
+static std::string joinValues(const std::vector<double> &values) {
+
+  std::ostringstream text;
+  text.precision(17);
+  for (size_t i=0; i<values.size(); i++) text << (i ? " " : "") << values[i];
+  return text.str();
+}
+static std::string joinWords(const std::vector<std::string> &words) {
+
+  std::ostringstream text;
+  for (size_t i=0; i<words.size(); i++)
+    text << words[i].size() << ':' << words[i];
+  text << ';';
+  return text.str();
+}
+static bool splitValues(const std::string &text, std::vector<double> *values) {
+
+  std::istringstream input(text);
+  std::string word;
+  double value;
+  values->clear();
+  while (input >> word) {
+    // NaN (kept by useOnlyN, excludeN) and infinity are written
+    // by operator<< as "nan", "inf" that operator>> cannot read
+    const char *number=word.c_str();
+    if ((word[0] == '-') || (word[0] == '+')) number++;
+    if (strcmp(number, "nan") == 0) value=MissNAN;
+    else if (strcmp(number, "inf") == 0)
+      value= (word[0] == '-') ? -std::numeric_limits<double>::infinity()
+                              : std::numeric_limits<double>::infinity();
+    else {
+      std::istringstream one(word);
+      if ((!(one >> value)) || (!one.eof())) return false;
+    }
+    values->push_back(value);
+  }
+  return true;
+}
+static bool splitWords(const std::string &text,
+                       std::vector<std::string> *words) {
+
+  std::string::size_type pos=0, colon, size, last=text.size()-1;
+  words->clear();
+  if ((text.empty()) || (text[last] != ';')) return false;
+  while (pos < last) {
+    colon=text.find(':', pos);
+    if ((colon == std::string::npos) || (colon == pos)
+        || (text.find_first_not_of("0123456789", pos) != colon)) return false;
+    size=strtoul(text.c_str()+pos, NULL, 10);
+    if (size > last-colon-1) return false;
+    words->push_back(text.substr(colon+1, size));
+    pos=colon+1+size;
+  }
+  return true;
+}
+/**********************************************************************/
+// write the selection in the last HDU of fileName (written by saveFits):
+// criteria of the saved quantities cols as header keywords and selection
+// bits of each written row in the added column SELBITS (private method)
+int Catalog::writeSelection(const std::string &fileName,
+                            const std::string origin,
+                            const std::vector<int> &cols,
+                            const bool selected) {
+
+  std::ostringstream sortie;
+  char keyName[FLEN_KEYWORD], colName[FLEN_VALUE], colForm[FLEN_VALUE];
+  int  c, flag, max=cols.size(), nbBytes=(max+2+7)/8, nbCols=0,
+       status=0, hdutype=ANY_HDU, nbHdu=0;
+  long w, l=0, nb, first, nbRows=0,
+       nrows= selected ? m_numSelRows : m_numRows;
+  // a READONLY handle on the same file must not be shared
+  const char lf = 0x0A;
+  if (m_fitsCache.m_key.compare(0, fileName.length()+1, fileName+lf) == 0)
+    m_fitsCache.close();
+
+  fitsfile *fptr=0;
+  fits_open_file(&fptr, fileName.c_str(), READWRITE, &status);
+  fits_get_num_hdus(fptr, &nbHdu, &status);
+  fits_movabs_hdu(fptr, nbHdu, &hdutype, &status);
+  auto putDouble=[&](const char *key, const double value,
+                     const char *comment) {
+    // 17 significant digits: value is read back exactly
+    fits_update_key_dbl(fptr, key, value, -17, comment, &status);
+  };
+  // global definition
+  flag=SEL_VERSION;
+  fits_update_key(fptr, TINT, "SELVERS", &flag,
+                  "selection of catalogAccess, bits in SELBITS", &status);
+  flag=m_criteriaORed;
+  fits_update_key(fptr, TLOGICAL, "SELORED", &flag,
+                  "OR instead of AND between criteria", &status);
+  flag=m_selRegion;
+  fits_update_key(fptr, TLOGICAL, "SELREGN", &flag,
+                  "elliptical region is selected", &status);
+  putDouble("SELRA",  m_selEllipseCentRA_deg,  "RA of region center (deg)");
+  putDouble("SELDEC", m_selEllipseCentDEC_deg, "DEC of region center (deg)");
+  putDouble("SELMAJ", m_selEllipseMajAxis_deg, "major axis of region (deg)");
+  putDouble("SELMIN", m_selEllipseMinAxis_deg, "minor axis of region (deg)");
+  putDouble("SELROT", m_selEllipseRot_deg, "rotation of region (deg)");
+  if ( !m_selection.empty() )
+    fits_update_key_longstr(fptr, "SELCUT", m_selection.c_str(),
+                            "general cut", &status);
+  // criteria of each column, only if not the default ones
+  for (c=0; (c<max) && (!status); c++) {
+    const Quantity &readQ=m_quantities[cols[c]];
+    if (readQ.m_lowerCut != NO_SEL_CUT) {
+      sprintf(keyName, "SLO%d", c+1);
+      putDouble(keyName, readQ.m_lowerCut, "lower cut");
+    }
+    if (readQ.m_upperCut != NO_SEL_CUT) {
+      sprintf(keyName, "SUP%d", c+1);
+      putDouble(keyName, readQ.m_upperCut, "upper cut");
+    }
+    if (readQ.m_precision != 10*Min_Prec) {
+      sprintf(keyName, "SPR%d", c+1);
+      putDouble(keyName, readQ.m_precision, "precision of list tests");
+    }
+    flag=readQ.m_excludeList+2*readQ.m_rejectNaN+4*readQ.m_cutORed;
+    if (flag != 2) {
+      sprintf(keyName, "SFL%d", c+1);
+      fits_update_key(fptr, TINT, keyName, &flag,
+                      "1: exclude list, 2: reject NaN, 4: cut OR list",
+                      &status);
+    }
+    if ( !readQ.m_listValN.empty() ) {
+      sprintf(keyName, "SLN%d", c+1);
+      fits_update_key_longstr(fptr, keyName,
+                              joinValues(readQ.m_listValN).c_str(),
+                              "list of values", &status);
+    }
+    if ( !readQ.m_listValS.empty() ) {
+      sprintf(keyName, "SLS%d", c+1);
+      fits_update_key_longstr(fptr, keyName,
+                              joinWords(readQ.m_listValS).c_str(),
+                              "list of strings (size:chars)", &status);
+    }
+    if ( !readQ.m_lowerVecCuts.empty() ) {
+      sprintf(keyName, "SVL%d", c+1);
+      fits_update_key_longstr(fptr, keyName,
+                              joinValues(readQ.m_lowerVecCuts).c_str(),
+                              "lower cuts of elements", &status);
+    }
+    if ( !readQ.m_upperVecCuts.empty() ) {
+      sprintf(keyName, "SVU%d", c+1);
+      fits_update_key_longstr(fptr, keyName,
+                              joinValues(readQ.m_upperVecCuts).c_str(),
+                              "upper cuts of elements", &status);
+    }
+  }
+  // bit 0: global, bit 1: region, bit c+2: criteria of column c+1
+  strcpy(colName, SEL_COLUMN);
+  sprintf(colForm, "%dB", nbBytes);
+  fits_get_num_cols(fptr, &nbCols, &status);
+  fits_insert_col(fptr, nbCols+1, colName, colForm, &status);
+  fits_get_rowsize(fptr, &nbRows, &status);
+  if (nbRows < 1) nbRows=1;
+  if (nbRows > nrows) nbRows=nrows;
+  try {
+    std::vector<unsigned char> bits(nbRows*nbBytes);
+    std::vector<int>           word(max);
+    std::vector<unsigned long> test(max);
+    for (c=0; c<max; c++) test[c]=bitPosition(cols[c], &word[c]);
+    std::vector<long> rows;
+    if (selected) selectedRows(&rows);
+    for (first=0; (first < nrows) && (!status); first+=nb) {
+      nb=nrows-first;
+      if (nb > nbRows) nb=nbRows;
+      std::fill(bits.begin(), bits.end(), 0);
+      for (w=0; w<nb; w++) {
+        l= (selected) ? rows[first+w] : first+w;
+        unsigned char *row=&bits[w*nbBytes];
+        row[0]=m_rowIsSelected[0][l] & 3ul;
+        for (c=0; c<max; c++) if (m_rowIsSelected[word[c]][l] & test[c])
+          row[(c+2)/8]|=1 << ((c+2)%8);
+      }
+      fits_write_col(fptr, TBYTE, nbCols+1, first+1, 1, nb*nbBytes, &bits[0],
+                     &status);
+    }
+  }
+  catch (const std::exception &prob) {
+    int closeStatus=0;
+    fits_close_file(fptr, &closeStatus);
+    sortie << "EXCEPTION writing selection: " << prob.what();
+    printErr(origin, sortie.str() );
+    throw;
+  }
+  if (status) {
+    char errText[FLEN_ERRMSG];
+    int  closeStatus=0;
+    fits_get_errstatus(status, errText);
+    if (fptr) fits_close_file(fptr, &closeStatus);
+    sortie << ": fits EXTENSION, cannot write selection (cfitsio error="
+           << status << ", " << errText << ")";
+    printErr(origin, sortie.str() );
+    return BAD_FITS;
+  }
+  fits_close_file(fptr, &status);
+  if (status) {
+    sortie << ": fits EXTENSION, cannot be closed (cfitsio error="
+           << status << ")";
+    printErr(origin, sortie.str() );
+    return BAD_FITS;
+  }
+  return IS_OK;
+}
+/**********************************************************************/
+// restore the selection written by saveFits in the table just imported
+// (criteria from keywords, bits from column SELBITS) without testing
+// any row; nothing is changed if absent or unreadable (private method)
+void Catalog::readSelection(const std::string origin) {
+
+  const std::string::size_type pos=m_filename.find(0x0A);
+  if (pos == std::string::npos) return;
+  fitsfile *fptr=(fitsfile *)openFits(m_filename.substr(0, pos),
+                                      m_filename.substr(pos+1));
+  if (!fptr) return;
+  int  i, version=0, status=0, keyStatus=0;
+  fits_read_key(fptr, TINT, "SELVERS", &version, NULL, &keyStatus);
+  if (keyStatus) return; /* no selection saved */
+
+  std::ostringstream sortie;
+  if (version != SEL_VERSION) {
+    sortie << "selection layout " << version << " unknown, not restored";
+    printWarn(origin, sortie.str() );
+    return;
+  }
+  char keyName[FLEN_KEYWORD], colName[FLEN_VALUE];
+  int  max=m_quantities.size(), nbBytes=(max+2+7)/8,
+       orCriteria=0, region=0, colNum=0, typecode=0, flag;
+  long repeat=0, width=0;
+  double ellipse[5]={0., 0., 0., 0., 0.};
+  std::string selection, text;
+  std::vector<Quantity> quants(m_quantities);
+  // true if key was read, false if absent (other errors in status)
+  auto found=[&]() {
+    if (keyStatus == KEY_NO_EXIST) keyStatus=0;
+    else if (keyStatus) status=keyStatus;
+    else return true;
+    return false;
+  };
+  auto getDouble=[&](const char *key, double *value) {
+    keyStatus=0;
+    fits_read_key(fptr, TDOUBLE, key, value, NULL, &keyStatus);
+    return found();
+  };
+  auto getText=[&](const char *key, std::string *value) {
+    char *longText=0;
+    int  freeStatus=0;
+    keyStatus=0;
+    fits_read_key_longstr(fptr, key, &longText, NULL, &keyStatus);
+    if ((!keyStatus) && (longText)) *value=longText;
+    if (longText) fits_free_memory(longText, &freeStatus);
+    return found();
+  };
+  fits_read_key(fptr, TLOGICAL, "SELORED", &orCriteria, NULL, &status);
+  fits_read_key(fptr, TLOGICAL, "SELREGN", &region, NULL, &status);
+  fits_read_key(fptr, TDOUBLE, "SELRA",  &ellipse[0], NULL, &status);
+  fits_read_key(fptr, TDOUBLE, "SELDEC", &ellipse[1], NULL, &status);
+  fits_read_key(fptr, TDOUBLE, "SELMAJ", &ellipse[2], NULL, &status);
+  fits_read_key(fptr, TDOUBLE, "SELMIN", &ellipse[3], NULL, &status);
+  fits_read_key(fptr, TDOUBLE, "SELROT", &ellipse[4], NULL, &status);
+  if (!status) getText("SELCUT", &selection);
+  bool ok=true;
+  for (i=0; (i<max) && (!status) && (ok); i++) {
+    Quantity &readQ=quants[i];
+    sprintf(keyName, "SLO%d", i+1);
+    getDouble(keyName, &readQ.m_lowerCut);
+    sprintf(keyName, "SUP%d", i+1);
+    getDouble(keyName, &readQ.m_upperCut);
+    sprintf(keyName, "SPR%d", i+1);
+    getDouble(keyName, &readQ.m_precision);
+    sprintf(keyName, "SFL%d", i+1);
+    keyStatus=0;
+    fits_read_key(fptr, TINT, keyName, &flag, NULL, &keyStatus);
+    if (found()) {
+      readQ.m_excludeList=(flag & 1);
+      readQ.m_rejectNaN  =(flag & 2);
+      readQ.m_cutORed    =(flag & 4);
+    }
+    sprintf(keyName, "SLN%d", i+1);
+    if (getText(keyName, &text)) ok=splitValues(text, &readQ.m_listValN);
+    sprintf(keyName, "SLS%d", i+1);
+    if ((ok) && (getText(keyName, &text)))
+      ok=splitWords(text, &readQ.m_listValS);
+    sprintf(keyName, "SVL%d", i+1);
+    if ((ok) && (getText(keyName, &text)))
+      ok=splitValues(text, &readQ.m_lowerVecCuts);
+    sprintf(keyName, "SVU%d", i+1);
+    if ((ok) && (getText(keyName, &text)))
+      ok=splitValues(text, &readQ.m_upperVecCuts);
+  }
+  // bits of the imported rows (the first ones of the table)
+  strcpy(colName, SEL_COLUMN);
+  fits_get_colnum(fptr, CASESEN, colName, &colNum, &status);
+  fits_get_coltype(fptr, colNum, &typecode, &repeat, &width, &status);
+  if ((status) || (!ok) || (colNum != max+1) || (typecode != TBYTE)
+      || (repeat != nbBytes)) {
+    sortie << "selection saved in fits EXTENSION is not valid (cfitsio error="
+           << status << "), not restored";
+    printWarn(origin, sortie.str() );
+    return;
+  }
+  long l, k, nb, first, nbRows=0;
+  fits_get_rowsize(fptr, &nbRows, &status);
+  if (nbRows < 1) nbRows=1;
+  if (nbRows > m_numRows) nbRows=m_numRows;
+  try {
+    int  anynul;
+    unsigned char zero=0;
+    std::vector<unsigned char> bits(nbRows*nbBytes);
+    std::vector<int>           word(max);
+    std::vector<unsigned long> test(max);
+    for (i=0; i<max; i++) test[i]=bitPosition(i, &word[i]);
+    fits_set_tscale(fptr, colNum, 1.0, 0.0, &status);
+    for (first=0; (first < m_numRows) && (!status); first+=nb) {
+      nb=m_numRows-first;
+      if (nb > nbRows) nb=nbRows;
+      fits_read_col(fptr, TBYTE, colNum, first+1, 1, nb*nbBytes, &zero,
+                    &bits[0], &anynul, &status);
+      if (status) break;
+      for (l=0; l<nb; l++) {
+        const unsigned char *row=&bits[l*nbBytes];
+        k=first+l;
+        m_rowIsSelected[0][k]=row[0] & 3ul;
+        for (i=0; i<max; i++) if (row[(i+2)/8] & (1 << ((i+2)%8)))
+          m_rowIsSelected[word[i]][k]|=test[i];
+      }
+    }
+  }
+  catch (const std::exception &prob) {
+    init_selection(origin);
+    sortie << "EXCEPTION reading selection: " << prob.what();
+    printErr(origin, sortie.str() );
+    throw;
+  }
+  if (status) {
+    // rows partly set: nothing selected, as after import
+    init_selection(origin);
+    sortie << "selection bits cannot be read (cfitsio error=" << status
+           << "), not restored";
+    printWarn(origin, sortie.str() );
+    return;
+  }
+  m_quantities.swap(quants);
+  m_selection=selection;
+  m_criteriaORed=orCriteria;
+  m_selRegion=region;
+  m_selEllipseCentRA_deg =ellipse[0];
+  m_selEllipseCentDEC_deg=ellipse[1];
+  m_selEllipseMajAxis_deg=ellipse[2];
+  m_selEllipseMinAxis_deg=ellipse[3];
+  m_selEllipseRot_deg    =ellipse[4];
+  if (m_selRegion) {
+    // as set by setSelEllipse()
+    m_selEllipse.at(0)=cos(m_selEllipseCentRA_deg * Angle_Conv);
+    m_selEllipse.at(1)=sin(m_selEllipseCentRA_deg * Angle_Conv);
+    m_selEllipse.at(2)=cos(m_selEllipseCentDEC_deg* Angle_Conv);
+    m_selEllipse.at(3)=sin(m_selEllipseCentDEC_deg* Angle_Conv);
+    m_selEllipse.at(4)=cos(m_selEllipseMajAxis_deg* Angle_Conv);
+  }
+  m_numSelRows=0;
+  for (l=0; l<m_numRows; l++) if (m_rowIsSelected[0][l] & 1) m_numSelRows++;
+  sortie << "selection restored from fits EXTENSION ( " << m_numSelRows
+         << " rows selected)";
+  printLog(1, sortie.str());
+}
+/**********************************************************************/
 // save whole catalog from memory to a FITS file
 int Catalog::saveFits(const std::string &fileName, const std::string &extName,
                       bool clobber, bool append) {
 
+  return saveFits(fileName, extName, std::vector<std::string>(), clobber,
+                  append);
+}
+/**********************************************************************/
+// save some quantities of whole catalog from memory to a FITS file
+int Catalog::saveFits(const std::string &fileName, const std::string &extName,
+                      const std::vector<std::string> &names,
+                      bool clobber, bool append) {
+
   const std::string origin="saveFits";
+  std::vector<int> cols;
   Table *myDOL=0;
   int err;
-  err=createFits(fileName, extName, clobber, append, origin, &myDOL);
+  err=exportColumns(origin, names, &cols);
+  if (err < IS_VOID) return err;
+  err=createFits(fileName, extName, clobber, append, origin, cols, &myDOL);
   if (err < IS_VOID) return err;
 
   std::ostringstream sortie;
   long tot=0l;
   int  i, j;
 
-  if (m_numRows > 0) {
+  if ((m_numRows > 0) && (!m_useTip) && (!tipFormat())) {
+    // rows are allocated by tip, then written by cfitsio
+    try {
+      myDOL->setNumRecords(m_numRows);
+    }
+    catch (const TipException &x) {
+      delete myDOL;
+      sortie << ": fits EXTENSION, cannot write at row#" << tot;
+      printErr(origin, sortie.str() );
+      return BAD_ROW;
+    }
+    delete myDOL; myDOL=0;
+    err=writeFits(fileName, "", origin, cols, false, false, &tot);
+    if (err < IS_VOID) return err;
+  }
+  else if (m_numRows > 0) {
   try {
     myDOL->setNumRecords(m_numRows);
-    Quantity readQ;
     double rowVal;
-    err=m_quantities.size();
-    std::vector<long> colNull(err, 0);
-    std::vector<bool> no_Null(err, true);
+    long   k, nbV;
+    std::vector<double> vect;
+    err=cols.size();
+    std::vector<double> colNull(err, 0.);
+    std::vector<bool>   no_Null(err, true);
     for (j=0; j < err; j++) {
-      readQ=m_quantities[j];
-      if ( !readQ.m_null.empty() ) {
-        colNull[j]=atoi( readQ.m_null.c_str() );
-        if (readQ.m_null[0]!=SepNull) no_Null[j]=false;
-      }
+      const Quantity &readQ=m_quantities[cols[j]];
+      no_Null[j]=!nullValue(readQ.m_null, &colNull[j]);
     }
     // Loop over all records (rows) and set values
     for (Table::Iterator itor=myDOL->begin(); itor != myDOL->end(); ++itor) {
       // double variable to hold the value of all the numeric fields
       for (j=0; j < err; j++) {
-        readQ=m_quantities[j];
+        const Quantity &readQ=m_quantities[cols[j]];
         i=readQ.m_index;
         if (readQ.m_type == Quantity::NUM) {
           rowVal= m_numericals[i].at(tot);
@@ -1558,6 +3050,20 @@ int Catalog::saveFits(const std::string &fileName, const std::string &extName,
         }
         else if (readQ.m_type == Quantity::STRING)
           (*itor)[readQ.m_name].set( m_strings[i].at(tot) );
+        else if (readQ.m_type == Quantity::VECTOR) {
+          nbV=readQ.m_vectorQs.size();
+          if (nbV == 0) continue; /* unsupported vector format */
+          vect.assign(m_vectors[i].begin()+tot*nbV,
+                      m_vectors[i].begin()+(tot+1)*nbV);
+          if ( !no_Null[j] ) for (k=0; k < nbV; k++) {
+#ifdef WIN32
+            if ( _isnan(vect[k]) ) vect[k]=colNull[j];
+#else
+            if ( std::isnan(vect[k]) ) vect[k]=colNull[j];
+#endif
+          }
+          (*itor)[readQ.m_name].set(vect);
+        }
       }
       tot++;
     }/* loop on rows */
@@ -1570,6 +3076,16 @@ int Catalog::saveFits(const std::string &fileName, const std::string &extName,
   }/* at least 1 row */
 
   delete myDOL; myDOL=0;
+  if (m_fitsSelection) {
+    err=writeSelection(fileName, origin, cols, false);
+    if (err < IS_VOID) return err;
+  }
+  // "*.fz": table tile compressed as with fpack
+  if ((tot > 0) && (fileName.size() > 3)
+      && (fileName.compare(fileName.size()-3, 3, ".fz") == 0)) {
+    err=tileFits(fileName, origin);
+    if (err < IS_VOID) return err;
+  }
   sortie << "output fits is closed ( " << tot << " rows written)";
   printLog(0, sortie.str());
   return IS_OK;
@@ -1580,40 +3096,68 @@ int Catalog::saveSelectedFits(const std::string &fileName,
                               const std::string &extName,
                               bool clobber, bool append) {
 
+  return saveSelectedFits(fileName, extName, std::vector<std::string>(),
+                          clobber, append);
+}
+/**********************************************************************/
+// save some quantities of selected rows from memory to a FITS file
+int Catalog::saveSelectedFits(const std::string &fileName,
+                              const std::string &extName,
+                              const std::vector<std::string> &names,
+                              bool clobber, bool append) {
+
   const std::string origin="saveSelectedFits";
+  std::vector<int> cols;
   Table *myDOL=0;
   int err;
-  err=createFits(fileName, extName, clobber, append, origin, &myDOL);
+  err=exportColumns(origin, names, &cols);
+  if (err < IS_VOID) return err;
+  err=createFits(fileName, extName, clobber, append, origin, cols, &myDOL);
   if (err < IS_VOID) return err;
 
   std::ostringstream sortie;
   long tot=0l;
   int  i, j;
 
-  if (m_numSelRows > 0) {
+  if ((m_numSelRows > 0) && (!m_useTip) && (!tipFormat())) {
+    // rows are allocated by tip, then written by cfitsio
+    try {
+      myDOL->setNumRecords(m_numSelRows);
+    }
+    catch (const TipException &x) {
+      delete myDOL;
+      sortie << ": fits EXTENSION, cannot write at row#" << tot;
+      printErr(origin, sortie.str() );
+      return BAD_ROW;
+    }
+    delete myDOL; myDOL=0;
+    err=writeFits(fileName, "", origin, cols, true, false, &tot);
+    if (err < IS_VOID) return err;
+  }
+  else if (m_numSelRows > 0) {
   try {
     myDOL->setNumRecords(m_numSelRows);
-    Quantity readQ;
     double rowVal;
-    err=m_quantities.size();
-    std::vector<long> colNull(err, 0);
-    std::vector<bool> no_Null(err, true);
+    long   l, nbV;
+    std::vector<double> vect;
+    err=cols.size();
+    std::vector<double> colNull(err, 0.);
+    std::vector<bool>   no_Null(err, true);
     for (j=0; j < err; j++) {
-      readQ=m_quantities[j];
-      if ( !readQ.m_null.empty() ) {
-        colNull[j]=atoi( readQ.m_null.c_str() );
-        if (readQ.m_null[0]!=SepNull) no_Null[j]=false;
-      }
+      const Quantity &readQ=m_quantities[cols[j]];
+      no_Null[j]=!nullValue(readQ.m_null, &colNull[j]);
     }
     Table::Iterator itor=myDOL->begin();
-    // Loop over all selected records (rows) and set values
-    // first bit indicates global selection
-    for (long k=0; k<m_numRows; k++) if (m_rowIsSelected[0].at(k) & 1) {
+    // Loop over the selected records (rows) only and set values
+    std::vector<long> rows;
+    selectedRows(&rows);
+    for (size_t n=0; n<rows.size(); n++) {
+      const long k=rows[n];
       for (j=0; j < err; j++) {
-        readQ=m_quantities[j];
+        const Quantity &readQ=m_quantities[cols[j]];
         i=readQ.m_index;
         if (readQ.m_type == Quantity::NUM) {
-          rowVal= m_numericals[i].at(tot);
+          rowVal= m_numericals[i].at(k);
           if ( no_Null[j] ) (*itor)[readQ.m_name].set(rowVal);
           else {
 #ifdef WIN32
@@ -1626,11 +3170,24 @@ int Catalog::saveSelectedFits(const std::string &fileName,
           }
         }
         else if (readQ.m_type == Quantity::STRING)
-          (*itor)[readQ.m_name].set( m_strings[i].at(tot) );
+          (*itor)[readQ.m_name].set( m_strings[i].at(k) );
+        else if (readQ.m_type == Quantity::VECTOR) {
+          nbV=readQ.m_vectorQs.size();
+          if (nbV == 0) continue; /* unsupported vector format */
+          vect.assign(m_vectors[i].begin()+k*nbV,
+                      m_vectors[i].begin()+(k+1)*nbV);
+          if ( !no_Null[j] ) for (l=0; l < nbV; l++) {
+#ifdef WIN32
+            if ( _isnan(vect[l]) ) vect[l]=colNull[j];
+#else
+            if ( std::isnan(vect[l]) ) vect[l]=colNull[j];
+#endif
+          }
+          (*itor)[readQ.m_name].set(vect);
+        }
       }
       tot++;
       itor++;
-      if (tot == m_numSelRows) break;
     }
   }
   catch (const TipException &x) {
@@ -1641,9 +3198,70 @@ int Catalog::saveSelectedFits(const std::string &fileName,
   }/* at least 1 selected row */
 
   delete myDOL; myDOL=0;
+  if (m_fitsSelection) {
+    err=writeSelection(fileName, origin, cols, true);
+    if (err < IS_VOID) return err;
+  }
+  // "*.fz": table tile compressed as with fpack
+  if ((tot > 0) && (fileName.size() > 3)
+      && (fileName.compare(fileName.size()-3, 3, ".fz") == 0)) {
+    err=tileFits(fileName, origin);
+    if (err < IS_VOID) return err;
+  }
   sortie << "output fits is closed ( " << tot << " rows written)";
   printLog(0, sortie.str());
   return IS_OK;
 }
 
+/**********************************************************************/
+// add rows of catalog from memory to an existing FITS table (private)
+int Catalog::appendRows(const std::string &fileName, const std::string &extName,
+                        const std::string origin, const bool selected) {
+
+  std::string text;
+  std::vector<int> cols;
+  long tot=0l;
+  int  err=exportColumns(origin, std::vector<std::string>(), &cols);
+  if (err < IS_VOID) return err;
+
+  if (fileName.empty()) {
+    text=": FILENAME is EMPTY";
+    printErr(origin, text);
+    return BAD_FILENAME;
+  }
+  std::fstream file (fileName.c_str(), std::ios::in);
+  if ( !file.is_open() ) {
+    text=": FILENAME \""+fileName+"\" does not exist";
+    printErr(origin, text);
+    return BAD_FILENAME;
+  }
+  file.close();
+  if (tipFormat()) {
+    text=": complex, bit or variable length columns cannot be appended";
+    printErr(origin, text);
+    return BAD_FITS;
+  }
+  err=writeFits(fileName, extName, origin, cols, selected, true, &tot);
+  if (err < IS_VOID) return err;
+
+  std::ostringstream sortie;
+  sortie << "output fits is closed ( " << tot << " rows appended)";
+  printLog(0, sortie.str());
+  return IS_OK;
+}
+/**********************************************************************/
+// add all rows of catalog from memory to an existing FITS table
+int Catalog::appendFits(const std::string &fileName,
+                        const std::string &extName) {
+
+  return appendRows(fileName, extName, "appendFits", false);
+}
+/**********************************************************************/
+// add selected rows of catalog from memory to an existing FITS table
+int Catalog::appendSelectedFits(const std::string &fileName,
+                                const std::string &extName) {
+
+  return appendRows(fileName, extName, "appendSelectedFits", true);
+}
+
 } // namespace catalogAccess
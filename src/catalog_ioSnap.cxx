@@ -0,0 +1,487 @@
+/**
+ * @file   catalog_ioSnap.cxx
+ * @brief  Save/reload of the whole catalog in a binary snapshot file.
+ *
+ * Layout (version 1, native byte order checked at load):
+ * - 64 bytes header: magic "CATSNAP\n", version, byte order mark,
+ *   number of rows, flags, description size, data offset, file size;
+ * - description: catalog members, quantities and the offset of each
+ *   column (all integers on 8 bytes, strings preceded by their length);
+ * - data, each array starting on 8 bytes: numerical columns and VECTOR
+ *   flat arrays (double), string columns as row offsets (int64) then
+ *   characters, optionally the selection bits (uint64).
+ *
+ * $Header $
+ *
+ */
+
+#include <cstring>
+#include <cstdio>     //for remove, rename
+#include <stdint.h>   //for int64_t
+#include "catalogAccess/catalog.h"
+
+namespace catalogAccess {
+
+/**********************************************************************/
+static const char SNAP_MAGIC[8]={'C','A','T','S','N','A','P','\n'};
+static const int32_t SNAP_VERSION=1,
+                     SNAP_ORDER  =0x01020304; // read reversed if swapped
+static const int64_t SNAP_HEAD   =64,         // header size (bytes)
+                     SNAP_SELECT =1;          // flag: selection saved
+
+// size rounded to next multiple of 8 bytes
+static inline int64_t snapAlign(const int64_t size) {
+  return (size+7) & ~(int64_t)7;
+}
+
+/**********************************************************************/
+// description of the snapshot built in memory
+class SnapWriter {
+public:
+  void put(const int64_t value) { m_data.append((const char *)&value, 8); }
+  void put(const double value)  { m_data.append((const char *)&value, 8); }
+  void put(const std::string &text) {
+    put((int64_t)text.size());
+    m_data.append(text);
+  }
+  void put(const std::vector<std::string> &list) {
+    put((int64_t)list.size());
+    for (size_t i=0; i<list.size(); i++) put(list[i]);
+  }
+  void put(const std::vector<double> &list) {
+    put((int64_t)list.size());
+    for (size_t i=0; i<list.size(); i++) put(list[i]);
+  }
+  std::string m_data;
+};
+/**********************************************************************/
+// description read from the mapped snapshot; after any read beyond
+// the description, m_ok is false and values are 0 or empty
+class SnapReader {
+public:
+  SnapReader(const char *begin, const char *end) :
+    m_c(begin), m_end(end), m_ok(true) {}
+  int64_t getLong() {
+    int64_t value=0;
+    if (m_end-m_c < 8) m_ok=false;
+    if (m_ok) { memcpy(&value, m_c, 8); m_c+=8; }
+    return value;
+  }
+  double getDouble() {
+    double value=0.;
+    if (m_end-m_c < 8) m_ok=false;
+    if (m_ok) { memcpy(&value, m_c, 8); m_c+=8; }
+    return value;
+  }
+  bool getBool() { return getLong() != 0; }
+  std::string getString() {
+    int64_t size=getLong();
+    if ((size < 0) || (m_end-m_c < size)) m_ok=false;
+    if (!m_ok) return "";
+    m_c+=size;
+    return std::string(m_c-size, size);
+  }
+  void get(std::vector<std::string> &list) {
+    int64_t size=getLong();
+    if ((size < 0) || ((m_end-m_c)/8 < size)) m_ok=false;
+    list.clear();
+    for (int64_t i=0; (m_ok) && (i<size); i++) list.push_back(getString());
+  }
+  void get(std::vector<double> &list) {
+    int64_t size=getLong();
+    if ((size < 0) || ((m_end-m_c)/8 < size)) m_ok=false;
+    list.clear();
+    for (int64_t i=0; (m_ok) && (i<size); i++) list.push_back(getDouble());
+  }
+  const char *m_c, *m_end;
+  bool m_ok;
+};
+
+/**********************************************************************/
+// save catalog from memory to a binary snapshot file
+int Catalog::saveSnapshot(const std::string &fileName, bool clobber,
+                          bool selection) {
+
+  const std::string origin="saveSnapshot";
+  std::string  text;
+  int  i, err;
+  long l;
+  err=checkImport(origin, true);
+  if (err < IS_VOID) return err;
+  if (fileName.empty()) {
+    printErr(origin, ": FILENAME is EMPTY");
+    return BAD_FILENAME;
+  }
+  if (!clobber) {
+    std::ifstream test(fileName.c_str());
+    if ( test.is_open() ) {
+      text=": FILENAME \""+fileName+"\" exist (clobber=no)";
+      printErr(origin, text);
+      return BAD_FILENAME;
+    }
+  }
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::trunc
+                                       | std::ios::binary);
+  if ( !file.is_open() ) {
+    text=": FILENAME \""+fileName+"\" cannot be written";
+    printErr(origin, text);
+    return BAD_FILENAME;
+  }
+  const int nbQuant=m_quantities.size(),
+            nbNum=m_numericals.size(),
+            nbStr=m_strings.size(),
+            nbVec=m_vectors.size(),
+            nbSel= selection ? m_rowIsSelected.size() : 0;
+  const int64_t nbRows=m_numRows;
+  SnapWriter desc;
+  try {
+    desc.put(m_code);      desc.put(m_URL);
+    desc.put(m_catName);   desc.put(m_catRef);
+    desc.put(m_tableName); desc.put(m_tableRef);
+    desc.put(m_filename);  desc.put((int64_t)m_filePos);
+    desc.put(m_posErrSys); desc.put(m_posErrFactor);
+    desc.put((int64_t)m_numOriRows);
+    desc.put((int64_t)m_indexErr);
+    desc.put((int64_t)m_indexRA);
+    desc.put((int64_t)m_indexDEC);
+    desc.put((int64_t)m_criteriaORed);
+    desc.put((int64_t)m_loadQuantity.size());
+    for (size_t k=0; k<m_loadQuantity.size(); k++)
+      desc.put((int64_t)m_loadQuantity[k]);
+    if (selection) {
+      desc.put(m_selection);
+      desc.put((int64_t)m_selRegion);
+      desc.put(m_selEllipseCentRA_deg);
+      desc.put(m_selEllipseCentDEC_deg);
+      desc.put(m_selEllipseMinAxis_deg);
+      desc.put(m_selEllipseMajAxis_deg);
+      desc.put(m_selEllipseRot_deg);
+      desc.put(m_selEllipse);
+      desc.put((int64_t)m_numSelRows);
+    }
+    // criteria are not saved without selection
+    const std::vector<std::string> noText;
+    const std::vector<double>      noValue;
+    desc.put((int64_t)nbQuant);
+    for (i=0; i<nbQuant; i++) {
+      const Quantity &readQ=m_quantities[i];
+      desc.put(readQ.m_name);   desc.put(readQ.m_comment);
+      desc.put(readQ.m_ucd);    desc.put(readQ.m_format);
+      desc.put(readQ.m_null);   desc.put((int64_t)readQ.m_type);
+      desc.put(readQ.m_unit);   desc.put((int64_t)readQ.m_index);
+      desc.put((int64_t)readQ.m_isGeneric);
+      desc.put(readQ.m_statError);
+      desc.put(readQ.m_sysError);
+      desc.put(readQ.m_vectorQs);
+      desc.put(selection ? readQ.m_listValS : noText);
+      desc.put(selection ? readQ.m_lowerCut : NO_SEL_CUT);
+      desc.put(selection ? readQ.m_upperCut : NO_SEL_CUT);
+      desc.put(selection ? readQ.m_listValN : noValue);
+      desc.put(selection ? readQ.m_lowerVecCuts : noValue);
+      desc.put(selection ? readQ.m_upperVecCuts : noValue);
+      desc.put((int64_t)readQ.m_excludeList);
+      desc.put(readQ.m_precision);
+      desc.put((int64_t)readQ.m_rejectNaN);
+      desc.put((int64_t)readQ.m_cutORed);
+    }
+    // offsets of all arrays, computed from the end of description
+    int64_t size=desc.m_data.size()+8*(4+nbNum+2*nbVec+3*nbStr+1),
+            pos=SNAP_HEAD+snapAlign(size);
+    std::vector<int64_t> strBytes(nbStr, 0);
+    desc.put((int64_t)nbNum);
+    for (i=0; i<nbNum; i++, pos+=nbRows*8) desc.put(pos);
+    desc.put((int64_t)nbVec);
+    for (i=0; i<nbVec; i++) {
+      desc.put((int64_t)m_vectors[i].size());
+      desc.put(pos);
+      pos+=m_vectors[i].size()*8;
+    }
+    desc.put((int64_t)nbStr);
+    for (i=0; i<nbStr; i++) {
+      for (l=0; l<m_numRows; l++) strBytes[i]+=m_strings[i][l].size();
+      desc.put(pos);
+      pos+=(nbRows+1)*8;
+      desc.put(pos);
+      desc.put(strBytes[i]);
+      pos+=snapAlign(strBytes[i]);
+    }
+    desc.put((int64_t)nbSel);
+    desc.put(pos);
+    pos+=nbSel*nbRows*8;
+
+    // header, then description and data
+    char    head[SNAP_HEAD];
+    int64_t values[6]={nbRows, selection ? SNAP_SELECT : 0,
+                       (int64_t)desc.m_data.size(),
+                       SNAP_HEAD+snapAlign(desc.m_data.size()), pos, 0};
+    memset(head, 0, SNAP_HEAD);
+    memcpy(head, SNAP_MAGIC, 8);
+    memcpy(head+8, &SNAP_VERSION, 4);
+    memcpy(head+12, &SNAP_ORDER, 4);
+    memcpy(head+16, values, sizeof(values));
+    const char zeros[8]={0,0,0,0,0,0,0,0};
+    file.write(head, SNAP_HEAD);
+    file.write(desc.m_data.data(), desc.m_data.size());
+    file.write(zeros, snapAlign(desc.m_data.size())-desc.m_data.size());
+    for (i=0; i<nbNum; i++) if (nbRows)
+      file.write((const char *)&m_numericals[i][0], nbRows*8);
+    for (i=0; i<nbVec; i++) if (m_vectors[i].size())
+      file.write((const char *)&m_vectors[i][0], m_vectors[i].size()*8);
+    std::vector<int64_t> offsets(nbRows+1);
+    std::string chars;
+    for (i=0; i<nbStr; i++) {
+      offsets[0]=0;
+      for (l=0; l<m_numRows; l++)
+        offsets[l+1]=offsets[l]+m_strings[i][l].size();
+      file.write((const char *)&offsets[0], (nbRows+1)*8);
+      // characters written by blocks of about 1 MB
+      chars.clear();
+      for (l=0; l<m_numRows; l++) {
+        chars+=m_strings[i][l];
+        if (chars.size() < (1 << 20)) continue;
+        file.write(chars.data(), chars.size());
+        chars.clear();
+      }
+      file.write(chars.data(), chars.size());
+      file.write(zeros, snapAlign(strBytes[i])-strBytes[i]);
+    }
+    for (i=0; i<nbSel; i++) {
+      std::vector<uint64_t> bits(m_rowIsSelected[i].begin(),
+                                 m_rowIsSelected[i].end());
+      if (nbRows) file.write((const char *)&bits[0], nbRows*8);
+    }
+  }
+  catch (const std::exception &prob) {
+    text=std::string("EXCEPTION writing snapshot: ")+prob.what();
+    printErr(origin, text);
+    throw;
+  }
+  file.close();
+  if ( file.fail() ) {
+    text=": FILENAME \""+fileName+"\" cannot be written";
+    printErr(origin, text);
+    return BAD_FILENAME;
+  }
+  std::ostringstream sortie;
+  sortie << "output snapshot is closed ( " << m_numRows << " rows written)";
+  printLog(0, sortie.str());
+  return IS_OK;
+}
+/**********************************************************************/
+// load catalog from a binary snapshot file (mapped in memory)
+int Catalog::loadSnapshot(const std::string &fileName) {
+
+  const std::string origin="loadSnapshot";
+  std::string text;
+  int  i, err;
+  long l;
+  err=checkImport(origin, false);
+  if (err < IS_VOID) return err;
+
+  TextView view(fileName);
+  const char *begin=NULL, *end=NULL;
+  if ((!view.isOpen()) || (view.isPacked())) {
+    text=": FILENAME \""+fileName+"\" cannot be read as snapshot";
+    printErr(origin, text);
+    return BAD_FILENAME;
+  }
+  view.nextLines(&begin, &end);
+  // check header
+  int32_t version=0, order=0;
+  int64_t values[6];
+  if ((end-begin < SNAP_HEAD) || (memcmp(begin, SNAP_MAGIC, 8) != 0)) {
+    printErr(origin, ": file is not a catalogAccess snapshot");
+    return BAD_FILETYPE;
+  }
+  memcpy(&version, begin+8, 4);
+  memcpy(&order, begin+12, 4);
+  memcpy(values, begin+16, sizeof(values));
+  if ((version != SNAP_VERSION) || (order != SNAP_ORDER)) {
+    std::ostringstream sortie;
+    sortie << ": snapshot version " << version << " or byte order ("
+           << std::hex << order << ") is not supported";
+    printErr(origin, sortie.str());
+    return BAD_FILETYPE;
+  }
+  const int64_t nbRows=values[0],
+                flags =values[1],
+                descSize=values[2],
+                dataPos =values[3],
+                fileSize=values[4];
+  if ((nbRows < 0) || (nbRows > fileSize/8) || (descSize < 0)
+      || (fileSize != end-begin)
+      || (SNAP_HEAD+descSize > dataPos) || (dataPos > fileSize)) {
+    printErr(origin, ": snapshot file is truncated or corrupted");
+    return BAD_FILETYPE;
+  }
+  // an array of size bytes at pos must be inside data
+  auto inside=[&](const int64_t pos, const int64_t size) {
+    return (pos >= dataPos) && (size >= 0) && (pos <= fileSize-size)
+           && (pos % 8 == 0);
+  };
+
+  bool ok;
+  try {
+    SnapReader desc(begin+SNAP_HEAD, begin+SNAP_HEAD+descSize);
+    m_code=desc.getString();      m_URL=desc.getString();
+    m_catName=desc.getString();   m_catRef=desc.getString();
+    m_tableName=desc.getString(); m_tableRef=desc.getString();
+    m_filename=desc.getString();  m_filePos=desc.getLong();
+    m_posErrSys=desc.getDouble(); m_posErrFactor=desc.getDouble();
+    m_numOriRows=desc.getLong();
+    m_indexErr=desc.getLong();
+    m_indexRA =desc.getLong();
+    m_indexDEC=desc.getLong();
+    m_criteriaORed=desc.getBool();
+    int64_t size=desc.getLong();
+    if ((size < 0) || (size > descSize)) desc.m_ok=false;
+    m_loadQuantity.clear();
+    for (l=0; (desc.m_ok) && (l<size); l++)
+      m_loadQuantity.push_back(desc.getBool());
+    if (flags & SNAP_SELECT) {
+      m_selection=desc.getString();
+      m_selRegion=desc.getBool();
+      m_selEllipseCentRA_deg =desc.getDouble();
+      m_selEllipseCentDEC_deg=desc.getDouble();
+      m_selEllipseMinAxis_deg=desc.getDouble();
+      m_selEllipseMajAxis_deg=desc.getDouble();
+      m_selEllipseRot_deg=desc.getDouble();
+      desc.get(m_selEllipse);
+      if (m_selEllipse.size() != 7) desc.m_ok=false;
+      m_numSelRows=desc.getLong();
+    }
+    else m_selEllipse.assign(7, 0.0);
+    size=desc.getLong();
+    if ((size < 0) || (size > descSize)) desc.m_ok=false;
+    m_quantities.clear();
+    for (l=0; (desc.m_ok) && (l<size); l++) {
+      Quantity readQ;
+      readQ.m_name=desc.getString();   readQ.m_comment=desc.getString();
+      readQ.m_ucd=desc.getString();    readQ.m_format=desc.getString();
+      readQ.m_null=desc.getString();
+      readQ.m_type=(Quantity::QuantityType)desc.getLong();
+      readQ.m_unit=desc.getString();   readQ.m_index=desc.getLong();
+      readQ.m_isGeneric=desc.getBool();
+      readQ.m_statError=desc.getString();
+      readQ.m_sysError=desc.getString();
+      desc.get(readQ.m_vectorQs);
+      desc.get(readQ.m_listValS);
+      readQ.m_lowerCut=desc.getDouble();
+      readQ.m_upperCut=desc.getDouble();
+      desc.get(readQ.m_listValN);
+      desc.get(readQ.m_lowerVecCuts);
+      desc.get(readQ.m_upperVecCuts);
+      readQ.m_excludeList=desc.getBool();
+      readQ.m_precision=desc.getDouble();
+      readQ.m_rejectNaN=desc.getBool();
+      readQ.m_cutORed=desc.getBool();
+      m_quantities.push_back(readQ);
+    }
+    // columns copied from the mapped file
+    int64_t pos, count;
+    const int nbNum=desc.getLong();
+    if ((nbNum < 0) || (nbNum > size)) desc.m_ok=false;
+    if (desc.m_ok) m_numericals.resize(nbNum);
+    for (i=0; (desc.m_ok) && (i<nbNum); i++) {
+      pos=desc.getLong();
+      if (!inside(pos, nbRows*8)) { desc.m_ok=false; break; }
+      const double *in=(const double *)(begin+pos);
+      m_numericals[i].assign(in, in+nbRows);
+    }
+    const int nbVec=desc.getLong();
+    if ((nbVec < 0) || (nbVec > size)) desc.m_ok=false;
+    if (desc.m_ok) m_vectors.resize(nbVec);
+    for (i=0; (desc.m_ok) && (i<nbVec); i++) {
+      count=desc.getLong();
+      pos=desc.getLong();
+      if ((count < 0) || (count > fileSize/8) || (!inside(pos, count*8))) {
+        desc.m_ok=false;
+        break;
+      }
+      const double *in=(const double *)(begin+pos);
+      m_vectors[i].assign(in, in+count);
+    }
+    const int nbStr=desc.getLong();
+    if ((nbStr < 0) || (nbStr > size)) desc.m_ok=false;
+    if (desc.m_ok) m_strings.resize(nbStr);
+    for (i=0; (desc.m_ok) && (i<nbStr); i++) {
+      pos=desc.getLong();
+      int64_t charPos=desc.getLong();
+      count=desc.getLong();
+      if ((!inside(pos, (nbRows+1)*8)) || (!inside(charPos, count))) {
+        desc.m_ok=false;
+        break;
+      }
+      const int64_t *offsets=(const int64_t *)(begin+pos);
+      const char    *chars=begin+charPos;
+      if ((offsets[0] != 0) || (offsets[nbRows] != count)) {
+        desc.m_ok=false;
+        break;
+      }
+      m_strings[i].resize(nbRows);
+      for (l=0; l<nbRows; l++) {
+        if ((offsets[l+1] < offsets[l]) || (offsets[l+1] > count)) {
+          desc.m_ok=false;
+          break;
+        }
+        m_strings[i][l].assign(chars+offsets[l], offsets[l+1]-offsets[l]);
+      }
+    }
+    // quantities must refer to existing columns
+    for (i=0; (desc.m_ok) && (i<(int)m_quantities.size()); i++) {
+      const Quantity &readQ=m_quantities[i];
+      switch (readQ.m_type) {
+      case Quantity::NUM:
+        if ((readQ.m_index < 0) || (readQ.m_index >= nbNum)) desc.m_ok=false;
+        break;
+      case Quantity::STRING: case Quantity::LOGICALS:
+        if ((readQ.m_index < 0) || (readQ.m_index >= nbStr)) desc.m_ok=false;
+        break;
+      case Quantity::VECTOR:
+        if ((readQ.m_index < 0) || (readQ.m_index >= nbVec)
+            || ((int64_t)m_vectors[readQ.m_index].size()
+                != nbRows*(int64_t)readQ.m_vectorQs.size())) desc.m_ok=false;
+        break;
+      default:
+        desc.m_ok=false;
+      }
+    }
+    if ((m_indexErr < -1) || (m_indexErr >= (int)m_quantities.size())
+        || (m_indexRA < -1) || (m_indexRA >= (int)m_quantities.size())
+        || (m_indexDEC < -1) || (m_indexDEC >= (int)m_quantities.size()))
+      desc.m_ok=false;
+    m_numRows=nbRows;
+    const int nbSel=desc.getLong();
+    pos=desc.getLong();
+    init_selection(origin);
+    if ((desc.m_ok) && (flags & SNAP_SELECT)) {
+      if ((nbSel != (int)m_rowIsSelected.size())
+          || (!inside(pos, nbSel*nbRows*8))) desc.m_ok=false;
+      for (i=0; (desc.m_ok) && (i<nbSel); i++) {
+        const uint64_t *in=(const uint64_t *)(begin+pos+i*nbRows*8);
+        for (l=0; l<nbRows; l++) m_rowIsSelected[i][l]=in[l];
+      }
+    }
+    ok=desc.m_ok;
+  }
+  catch (const std::exception &prob) {
+    deleteContent();
+    deleteDescription();
+    text=std::string("EXCEPTION loading snapshot: ")+prob.what();
+    printErr(origin, text);
+    throw;
+  }
+  if (!ok) {
+    deleteContent();
+    deleteDescription();
+    printErr(origin, ": snapshot file is truncated or corrupted");
+    return BAD_FILETYPE;
+  }
+  std::ostringstream sortie;
+  sortie << "snapshot loaded ( " << m_numRows << " rows, "
+         << m_quantities.size() << " quantities)";
+  printLog(1, sortie.str());
+  return m_numRows;
+}
+
+} // namespace catalogAccess
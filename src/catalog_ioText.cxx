@@ -9,45 +9,977 @@
  */
 
 #include <cstring>
+#include <cstdio>     //for FILE
+#include <clocale>    //for localeconv
+#include <iterator>   //for istreambuf_iterator
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <zlib.h>     //for gzread
+#include <bzlib.h>    //for BZ2_bzRead
+#ifndef WIN32
+#include <fcntl.h>    //for open
+#include <sys/mman.h> //for mmap
+#include <sys/stat.h> //for fstat
+#include <unistd.h>   //for close
+#endif
 #include "catalogAccess/catalog.h"
 
 namespace catalogAccess {
 
+/**********************************************************************/
+// size of uncompressed blocks, and number of blocks waiting for parser
+static const long PACK_BLOCK=1L << 20;
+static const unsigned int PACK_QUEUE=4;
+
+/**********************************************************************/
+// sequential reading of a gzip or bzip2 file
+class Unpacker {
+public:
+  Unpacker() : m_gz(0), m_file(0), m_bz(0) {}
+  ~Unpacker() { close(); }
+  static int kind(const std::string &fileName);
+      // 1 for gzip, 2 for bzip2, 0 otherwise (from first bytes)
+  bool open(const std::string &fileName);
+  long read(char *buffer, const long size);
+      // number of uncompressed bytes, 0 at end, -1 on error
+  void close();
+private:
+  gzFile  m_gz;
+  FILE   *m_file;
+  BZFILE *m_bz;   // NULL at end of bzip2 file
+};
+/**********************************************************************/
+int Unpacker::kind(const std::string &fileName) {
+
+  unsigned char magic[3];
+  int  kind=0;
+  FILE *file=fopen(fileName.c_str(), "rb");
+  if (file == NULL) return 0;
+  if (fread(magic, 1, 3, file) == 3) {
+    if ((magic[0] == 0x1F) && (magic[1] == 0x8B)) kind=1;
+    else if ((magic[0] == 'B') && (magic[1] == 'Z') && (magic[2] == 'h'))
+      kind=2;
+  }
+  fclose(file);
+  return kind;
+}
+/**********************************************************************/
+bool Unpacker::open(const std::string &fileName) {
+
+  int err;
+  close();
+  switch (kind(fileName)) {
+  case 1:
+    m_gz=gzopen(fileName.c_str(), "rb");
+    if (m_gz == NULL) return false;
+    gzbuffer(m_gz, 1 << 17);
+    return true;
+  case 2:
+    m_file=fopen(fileName.c_str(), "rb");
+    if (m_file == NULL) return false;
+    m_bz=BZ2_bzReadOpen(&err, m_file, 0, 0, NULL, 0);
+    if (err == BZ_OK) return true;
+    close();
+  }
+  return false;
+}
+/**********************************************************************/
+long Unpacker::read(char *buffer, const long size) {
+
+  long tot=0;
+  int  err, nb;
+  if (m_gz) {
+    nb=gzread(m_gz, buffer, size);
+    if (nb > 0) return nb;
+    // truncated file is not a normal end
+    gzerror(m_gz, &err);
+    return ((nb < 0) || ((err != Z_OK) && (err != Z_STREAM_END))) ? -1 : 0;
+  }
+  if (!m_file) return -1;
+  while ((m_bz) && (tot < size)) {
+    nb=BZ2_bzRead(&err, m_bz, buffer+tot, size-tot);
+    if ((err != BZ_OK) && (err != BZ_STREAM_END)) return -1;
+    tot+=nb;
+    if (err == BZ_OK) continue;
+    // concatenated streams (as with bzip2 -c a b > c): read next one
+    void *unused;
+    char rest[BZ_MAX_UNUSED];
+    BZ2_bzReadGetUnused(&err, m_bz, &unused, &nb);
+    if (err != BZ_OK) return -1;
+    memcpy(rest, unused, nb);
+    BZ2_bzReadClose(&err, m_bz);
+    m_bz=NULL;
+    if (nb == 0) {
+      int next=fgetc(m_file);
+      if (next == EOF) break;
+      ungetc(next, m_file);
+    }
+    m_bz=BZ2_bzReadOpen(&err, m_file, 0, 0, rest, nb);
+    if (err != BZ_OK) { m_bz=NULL; return -1; }
+  }
+  return tot;
+}
+/**********************************************************************/
+void Unpacker::close() {
+
+  int err;
+  if (m_gz) gzclose(m_gz);
+  if (m_bz) BZ2_bzReadClose(&err, m_bz);
+  if (m_file) fclose(m_file);
+  m_gz=NULL; m_bz=NULL; m_file=NULL;
+}
+
+/**********************************************************************/
+// gzip file written by a second thread which compresses the blocks
+// while the next ones are formatted (at most PACK_QUEUE are waiting)
+class Packer {
+public:
+  Packer() : m_gz(0), m_stop(false), m_failed(false) {}
+  ~Packer() { close(); }
+  static bool wanted(const std::string &fileName);
+      // true if fileName ends with ".gz"
+  bool open(const std::string &fileName);
+  void write(std::string &block);
+      // block is moved (emptied) to the queue of the compressing thread
+  bool close();
+      // false if some data could not be compressed or written
+private:
+  void consume();               // loop of compressing thread
+  gzFile      m_gz;
+  std::thread m_worker;
+  std::mutex  m_lock;           // for the 2 members below
+  std::condition_variable m_cond;
+  std::deque<std::string> m_queue;
+  bool m_stop;
+  bool m_failed;                // set by thread, read after join
+};
+/**********************************************************************/
+bool Packer::wanted(const std::string &fileName) {
+
+  const std::string::size_type size=fileName.size();
+  return ((size > 3) && (fileName.compare(size-3, 3, ".gz") == 0));
+}
+/**********************************************************************/
+bool Packer::open(const std::string &fileName) {
+
+  close();
+  m_gz=gzopen(fileName.c_str(), "wb");
+  if (m_gz == NULL) return false;
+  gzbuffer(m_gz, 1 << 17);
+  m_stop=false;
+  m_failed=false;
+  m_worker=std::thread(&Packer::consume, this);
+  return true;
+}
+/**********************************************************************/
+void Packer::write(std::string &block) {
+
+  if ((!m_gz) || (block.empty())) return;
+  std::unique_lock<std::mutex> lock(m_lock);
+  m_cond.wait(lock, [this]() { return m_queue.size() < PACK_QUEUE; });
+  m_queue.push_back(std::string());
+  m_queue.back().swap(block);
+  m_cond.notify_all();
+}
+/**********************************************************************/
+void Packer::consume() {
+
+  std::string block;
+  while (1) {
+    {
+      std::unique_lock<std::mutex> lock(m_lock);
+      m_cond.wait(lock, [this]() { return (m_stop) || (!m_queue.empty()); });
+      if (m_queue.empty()) break;
+      block.swap(m_queue.front());
+      m_queue.pop_front();
+      m_cond.notify_all();
+    }
+    // after an error, blocks are only removed from the queue
+    if ((!m_failed) && (gzwrite(m_gz, block.data(), block.size())
+                        != (int)block.size())) m_failed=true;
+    block.clear();
+  }
+}
+/**********************************************************************/
+bool Packer::close() {
+
+  if (!m_gz) return !m_failed;
+  {
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_stop=true;
+  }
+  m_cond.notify_all();
+  m_worker.join();
+  if (gzclose(m_gz) != Z_OK) m_failed=true;
+  m_gz=NULL;
+  return !m_failed;
+}
+
+/**********************************************************************/
+// compressed file: one thread uncompresses blocks, waiting
+// when PACK_QUEUE blocks are not yet read by the parser
+struct Catalog::TextView::Packed {
+  Packed() : m_done(false), m_stop(false), m_failed(false), m_offset(0) {}
+  void produce();               // loop of uncompressing thread
+  bool pop();                   // next block in m_block, false at end
+  Unpacker    m_unpacker;
+  std::thread m_worker;
+  std::mutex  m_lock;           // for the 4 members below
+  std::condition_variable m_cond;
+  std::deque<std::vector<char> > m_queue;
+  bool m_done, m_stop, m_failed;
+  std::vector<char> m_block;    // block in stream get area
+  std::vector<char> m_lines;    // data given by nextLines()
+  long long m_offset;           // stream position of m_block start
+};
+/**********************************************************************/
+void Catalog::TextView::Packed::produce() {
+
+  while (1) {
+    std::vector<char> block(PACK_BLOCK);
+    long nb=m_unpacker.read(&block[0], PACK_BLOCK);
+    std::unique_lock<std::mutex> lock(m_lock);
+    if (nb < 0) m_failed=true;
+    if (nb > 0) {
+      block.resize(nb);
+      m_cond.wait(lock, [this]() {
+        return (m_stop) || (m_queue.size() < PACK_QUEUE); });
+      if (!m_stop) {
+        m_queue.push_back(std::move(block));
+        m_cond.notify_all();
+        continue;
+      }
+    }
+    m_done=true;
+    m_cond.notify_all();
+    break;
+  }
+  m_unpacker.close();
+}
+/**********************************************************************/
+bool Catalog::TextView::Packed::pop() {
+
+  std::unique_lock<std::mutex> lock(m_lock);
+  m_cond.wait(lock, [this]() { return (m_done) || (!m_queue.empty()); });
+  if (m_queue.empty()) return false;
+  m_block.swap(m_queue.front());
+  m_queue.pop_front();
+  m_cond.notify_all();
+  return true;
+}
+
+/**********************************************************************/
+// whole text file mapped in memory, or copied if it cannot be mapped
+// (WIN32, pipe, ...); compressed file is read as a stream
+Catalog::TextView::TextView(const std::string &fileName) :
+  m_data(0), m_size(0), m_last(0), m_name(fileName), m_time(0),
+  m_ok(false), m_map(0), m_packed(0) {
+
+  setg(0, 0, 0);
+  if (Unpacker::kind(fileName)) {
+    m_packed=new Packed();
+    if ( !m_packed->m_unpacker.open(fileName) ) {
+      delete m_packed;
+      m_packed=0;
+      return;
+    }
+    m_packed->m_worker=std::thread(&Packed::produce, m_packed);
+    m_ok=true;
+    return;
+  }
+  #ifndef WIN32
+  int fd=open(fileName.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat info;
+    if ((fstat(fd, &info) == 0) && (S_ISREG(info.st_mode))) {
+      m_size=info.st_size;
+      m_time=info.st_mtime;
+      m_ok=true;
+      if (m_size > 0) {
+        void *addr=mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) m_ok=false;
+        else {
+          m_map=addr;
+          m_data=(const char *)addr;
+          madvise(addr, m_size, MADV_SEQUENTIAL);
+        }
+      }
+    }
+    ::close(fd);
+  }
+  #endif
+  if (!m_ok) {
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+    if ( !file.is_open() ) return;
+    // a directory can be opened but not read
+    try {
+      m_copy.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+    }
+    catch (const std::exception &) { m_copy.clear(); }
+    m_size=m_copy.size();
+    if (m_size) m_data=&m_copy[0];
+    m_ok=true;
+  }
+  // get area of the stream is the whole file
+  char *start=const_cast<char *>(m_data);
+  setg(start, start, start+m_size);
+  if (m_size) m_last=m_data[m_size-1];
+}
+/**********************************************************************/
+Catalog::TextView::~TextView() {
+
+  if (m_packed) {
+    {
+      std::lock_guard<std::mutex> lock(m_packed->m_lock);
+      m_packed->m_stop=true;
+    }
+    m_packed->m_cond.notify_all();
+    m_packed->m_worker.join();
+    delete m_packed;
+  }
+  #ifndef WIN32
+  if (m_map) munmap(m_map, m_size);
+  #endif
+}
+/**********************************************************************/
+bool Catalog::TextView::failed() const {
+
+  if (!m_packed) return false;
+  std::lock_guard<std::mutex> lock(m_packed->m_lock);
+  return m_packed->m_failed;
+}
+/**********************************************************************/
+// true if the file is compressed and does not start like FITS
+bool Catalog::TextView::packedText(const std::string &fileName) {
+
+  Unpacker file;
+  char head[6];
+  if ( !file.open(fileName) ) return false;
+  return ((file.read(head, 6) < 6) || (strncmp(head, "SIMPLE", 6) != 0));
+}
+/**********************************************************************/
+// next uncompressed block (only called for compressed file)
+Catalog::TextView::int_type Catalog::TextView::underflow() {
+
+  if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+  if (!m_packed) return traits_type::eof();
+  m_packed->m_offset+=egptr()-eback();
+  if ( !m_packed->pop() ) {
+    setg(0, 0, 0);
+    return traits_type::eof();
+  }
+  std::vector<char> &block=m_packed->m_block;
+  m_size+=block.size();
+  m_last=block.back();
+  setg(&block[0], &block[0], &block[0]+block.size());
+  return traits_type::to_int_type(block[0]);
+}
+/**********************************************************************/
+// data from stream position: rest of file if it is in memory,
+// otherwise rest of current block and next block up to its last LF
+bool Catalog::TextView::nextLines(const char **begin, const char **end) {
+
+  if (!m_packed) {
+    if (gptr() >= egptr()) return false;
+    *begin=gptr();
+    *end=egptr();
+    setg(eback(), egptr(), egptr());
+    return true;
+  }
+  std::vector<char> &lines=m_packed->m_lines;
+  lines.assign(gptr(), egptr());
+  setg(eback(), egptr(), egptr());
+  while (underflow() != traits_type::eof()) {
+    char *lf=egptr();
+    while ((lf > gptr()) && (lf[-1] != '\n')) lf--;
+    bool found=(lf > gptr());
+    if (!found) lf=egptr();
+    lines.insert(lines.end(), gptr(), lf);
+    setg(eback(), lf, egptr());
+    if (found) break;
+  }
+  if (lines.empty()) return false;
+  *begin=&lines[0];
+  *end=*begin+lines.size();
+  return true;
+}
+/**********************************************************************/
+// same counting as getline() loop of getMaxNumRows(), without copy:
+// memchr (vectorized by the C library) finds the end of each line
+long Catalog::TextView::dataLines(bool *table) const {
+
+  if (m_packed) return -1;
+  const char *c=gptr(), *end=egptr(), *eol;
+  long nb=1, // line starting at c
+       length;
+  *table=false;
+  while (1) {
+    eol=(const char *)memchr(c, '\n', end-c);
+    length= (eol == NULL) ? end-c : eol-c;
+    if (length < 2) break;
+    if ((c[0] == '#') && (length >= 6) && (strncmp(c, "#Table", 6) == 0)) {
+      *table=true;
+      break;
+    }
+    if (eol == NULL) break;
+    nb++;
+    c=eol+1;
+  }
+  return nb;
+}
+/**********************************************************************/
+// needed by tellg() and seekg() on the stream
+Catalog::TextView::pos_type Catalog::TextView::seekoff(off_type off,
+                   std::ios_base::seekdir way, std::ios_base::openmode which) {
+
+  if (which & std::ios_base::out) return pos_type(off_type(-1));
+  if (m_packed) {
+    // compressed: only forward, by reading the stream
+    off_type at=m_packed->m_offset+(gptr()-eback());
+    if (way == std::ios_base::beg) off-=at;
+    else if (way != std::ios_base::cur) return pos_type(off_type(-1));
+    if (off < 0) return pos_type(off_type(-1));
+    while (off > egptr()-gptr()) {
+      off-=egptr()-gptr();
+      at+=egptr()-gptr();
+      setg(eback(), egptr(), egptr());
+      if (underflow() == traits_type::eof()) return pos_type(off_type(-1));
+    }
+    setg(eback(), gptr()+off, egptr());
+    return pos_type(at+off);
+  }
+  off_type at=off;
+  if (way == std::ios_base::cur) at+=gptr()-eback();
+  else if (way == std::ios_base::end) at+=m_size;
+  if ((at < 0) || (at > (off_type)m_size)) return pos_type(off_type(-1));
+  setg(eback(), eback()+at, egptr());
+  return pos_type(at);
+}
+/**********************************************************************/
+Catalog::TextView::pos_type Catalog::TextView::seekpos(pos_type pos,
+                   std::ios_base::openmode which) {
+
+  return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+// minimal size (bytes) of text data parsed by one thread
+static const long TEXT_CHUNK=1L << 20;
+
+// kind of each line of a TextChunk (bits)
+static const unsigned char LINE_SHORT=1,  // less than 2 char
+                           LINE_EMPTY=2,  // empty or starting with CR
+                           LINE_TABLE=4,  // start of a second table
+                           LINE_NOSEP=8,  // without separator
+                           LINE_ROW  =16, // data row
+                           LINE_MANY =32, // row with too many quantities
+                           LINE_FEW  =64, // row without all quantities
+                           LINE_CUT  =128;// row failing criteria
+
+/**********************************************************************/
+// exact powers of ten for fast conversion (up to 10^22, 53 bits mantissa)
+static const double s_pow10[23]={1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+  1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+  1e20, 1e21, 1e22};
+
+/**********************************************************************/
+// converts the number in cell[0..length-1] without copy, independently
+// of the locale; returns false if the result would not be exactly
+// the one of strtod (more than 19 digits, large exponent, nan, ...).
+// Integer parsing is done first, then decimal point and exponent
+// if the column format is not 'I'.
+static bool fastNumber(const char *cell, int length, const bool integer,
+                       double *value) {
+
+  const char *c=cell, *end=cell+length;
+  unsigned long long mant=0ull;
+  int  nbDigits=0, // significant digits in mant
+       exp10=0;
+  bool negative=false, found=false;
+
+  while ((c < end) && (*c == ' ')) c++;
+  if ((c < end) && ((*c == '-') || (*c == '+'))) negative=(*c++ == '-');
+  // integer part, leading zeros are not significant
+  for (; (c < end) && (*c >= '0') && (*c <= '9'); c++) {
+    found=true;
+    if ((mant == 0ull) && (*c == '0')) continue;
+    if (++nbDigits > 19) return false;
+    mant=mant*10ull+(*c-'0');
+  }
+  if ((c < end) && (!integer)) {
+    if (*c == '.') {
+      for (c++; (c < end) && (*c >= '0') && (*c <= '9'); c++) {
+        found=true;
+        exp10--;
+        if ((mant == 0ull) && (*c == '0')) continue;
+        if (++nbDigits > 19) return false;
+        mant=mant*10ull+(*c-'0');
+      }
+    }
+    if ((found) && (c < end) && ((*c == 'e') || (*c == 'E'))) {
+      bool negExp=false;
+      int  e=0;
+      c++;
+      if ((c < end) && ((*c == '-') || (*c == '+'))) negExp=(*c++ == '-');
+      if ((c == end) || (*c < '0') || (*c > '9')) return false;
+      for (; (c < end) && (*c >= '0') && (*c <= '9'); c++) {
+        if (e > 9999) return false;
+        e=e*10+(*c-'0');
+      }
+      exp10+= negExp ? -e : e;
+    }
+  }
+  if ((!found) || (c != end)) return false;
+  // both mant and 10^exp10 are exact doubles: one rounding only
+  if (mant > (1ull << 53)) return false;
+  double result=(double)mant;
+  if (mant != 0ull) {
+    if ((exp10 < -22) || (exp10 > 22)) return false;
+    if (exp10 < 0) result/=s_pow10[-exp10];
+    else result*=s_pow10[exp10];
+  }
+  *value= negative ? -result : result;
+  return true;
+}
+
+/**********************************************************************/
+// value of a non empty cell (without trailing spaces) as given by strtod
+static double textNumber(const char *cell, int length, const bool integer) {
+
+  double value;
+  if (fastNumber(cell, length, integer, &value)) return value;
+  // rare cases: strtod needs a C string copied on the stack (on the heap
+  // for long cells), with the decimal point of the current locale
+  char stack[64],
+       point=*std::localeconv()->decimal_point;
+  std::string heap;
+  char *number=stack;
+  if (length > 63) {
+    heap.assign(cell, length);
+    number=&heap[0];
+  }
+  else {
+    memcpy(number, cell, length);
+    number[length]='\0';
+  }
+  if (point != '.') {
+    char *dot=strchr(number, '.');
+    if (dot) *dot=point;
+  }
+  return std::strtod(number, NULL);
+}
+
 /**********************************************************************/
 // loads Ascii input in m_quantities (private method)
 // suppose that index really exists: 0 <= index < m_quantities.size()
-void Catalog::translate_cell(std::string mot, const int index) {
+void Catalog::translate_cell(const char *cell, int length, const int index,
+                      const long row,
+                      std::vector<std::vector<double> > &numericals,
+                      std::vector<std::vector<std::string> > &strings) const {
 
-  int  j, last;
+  int  j;
   char form; 
 
   // remove trailing spaces
-  last=mot.length();
-/* useless Warning, happen many times for last column of 3EG objects (EGRET)
-  if (last == 0) {
-    std::ostringstream sortie;
-    sortie << "one quantity has no character (row #" << m_numRows+1 << ")";
-    printWarn("private translate_cell", sortie.str());
-  }
-  else {*/
-  if (last) {
-    do last--;
-    while ( (last >= 0) && (mot.at(last) == ' ') );
-  }
-  last++;
+  while ((length > 0) && (cell[length-1] == ' ')) length--;
   j=m_quantities[index].m_index;
   form=m_quantities[index].m_format.at(0);
   if (form == 'A') {
-    m_strings[j].at(m_numRows)=mot.substr(0, last);
+    strings[j].at(row).assign(cell, length);
   }
   else {
-    if (last) {
-      m_numericals[j].at(m_numRows)=std::atof(mot.c_str());
-    }
+    if (length)
+      numericals[j].at(row)=textNumber(cell, length, form == 'I');
     else
-      m_numericals[j].at(m_numRows)=MissNAN;
+      numericals[j].at(row)=MissNAN;
+  }
+
+}
+/**********************************************************************/
+// criteria checked while loading rows of importSelected (ANDed)
+struct Catalog::RowFilter {
+  std::vector<char> m_column;  // 1 for file column loaded in first pass
+  std::vector<int>  m_quant;   // index in m_quantities of criteria
+  std::vector<int>  m_fileCol; // file column of criteria
+  std::vector<std::vector<std::string> > m_lists; // STRING criteria
+                               // (lower case if m_cutORed)
+  bool m_region;               // true if region must be checked
+};
+
+/**********************************************************************/
+/* PRIVATE METHOD is only called by loadText for importSelected
+   (criteria must be ANDed: a row failing one criteria is erased)
+*/
+bool Catalog::init_filter(RowFilter *filter) {
+
+  std::vector<bool> isSelected;
+  if ((m_criteriaORed) || (!existCriteria(&isSelected))) return false;
+  int i, j, k,
+      nbQuant=m_quantities.size(),
+      nbCol=m_loadQuantity.size(),
+      (*pfunc)(int)=tolower; // function used by transform
+  std::vector<char> cutQuant(nbQuant, 0);
+  filter->m_region=isSelected[0];
+  if (filter->m_region) {
+    if ((m_indexRA < 0) || (m_indexDEC < 0)) return false;
+    cutQuant.at(m_indexRA)=cutQuant.at(m_indexDEC)=1;
+  }
+  filter->m_quant.clear();
+  filter->m_fileCol.clear();
+  filter->m_lists.clear();
+  for (i=0; i<nbQuant; i++) if (isSelected[i+1]) {
+    const Quantity &readQ=m_quantities[i];
+    std::vector<std::string> list;
+    if (readQ.m_type == Quantity::STRING) {
+      list=readQ.m_listValS;
+      if (readQ.m_cutORed) for (j=0; j<(int)list.size(); j++)
+        std::transform(list[j].begin(), list[j].end(), list[j].begin(), pfunc);
+    }
+    else if (readQ.m_type != Quantity::NUM) return false;
+    filter->m_quant.push_back(i);
+    filter->m_lists.push_back(list);
+    cutQuant[i]=1;
+  }
+  // file columns of quantities with criteria
+  std::vector<int> fileCol(nbQuant, -1);
+  filter->m_column.assign(nbCol, 0);
+  for (j=0, k=0; j<nbCol; j++) if (m_loadQuantity[j]) {
+    if (k < nbQuant) { filter->m_column[j]=cutQuant[k]; fileCol[k]=j; }
+    k++;
+  }
+  for (i=0; i<(int)filter->m_quant.size(); i++)
+    filter->m_fileCol.push_back(fileCol[filter->m_quant[i]]);
+  return true;
+}
+
+/**********************************************************************/
+// same tests as importSelected on a loaded row (private method)
+bool Catalog::passRow(const RowFilter &filter, const long row,
+               const std::vector<std::vector<double> > &numericals,
+               const std::vector<std::vector<std::string> > &strings) const {
+
+  int i, j, nbV,
+      (*pfunc)(int)=tolower; // function used by transform
+  bool check;
+  for (i=0; i<(int)filter.m_quant.size(); i++) {
+    const int index=filter.m_quant[i];
+    const Quantity &readQ=m_quantities[index];
+    if (readQ.m_type == Quantity::STRING) {
+      const std::vector<std::string> &list=filter.m_lists[i];
+      std::string mot=strings[readQ.m_index][row];
+      if (readQ.m_cutORed)
+        std::transform(mot.begin(), mot.end(), mot.begin(), pfunc);
+      check=readQ.m_excludeList;
+      nbV=list.size();
+      for (j=0; j<nbV; j++) {
+        if (mot == list[j]) {check=!readQ.m_excludeList; break;}
+      }
+    }
+    else {
+      double myVal=numericals[readQ.m_index][row];
+      if (!readQ.m_cutORed) // usual case
+        check=checkNUM(myVal, index, readQ.m_excludeList,
+                       readQ.m_rejectNaN, readQ.m_precision);
+      else
+        check=checkNUMor(myVal, index, readQ.m_rejectNaN, readQ.m_precision);
+    }
+    if (!check) return false;
+  }
+  if (filter.m_region)
+    return inRegion(numericals[m_quantities[m_indexRA].m_index][row],
+                    numericals[m_quantities[m_indexDEC].m_index][row]);
+  return true;
+}
+
+/**********************************************************************/
+// loads the cells of one data line (private method)
+int Catalog::split_row(const char *line, const char *eol, const char *pos,
+                const char sep, const int nbQuant, const bool selected,
+                const long row, std::vector<std::vector<double> > &numericals,
+                std::vector<std::vector<std::string> > &strings,
+                const RowFilter *filter, bool *keep) const {
+
+  const char *cell=line,
+             *first=pos;
+  int  i=0,
+       skip=0,
+       status=0;
+  *keep=true;
+  if (filter) {
+    // cells with criteria first: others are not converted if row fails
+    do {
+      if (pos == NULL) pos=eol;
+      if (i >= nbQuant) { status=1; break; }
+      if (m_loadQuantity[i]) {
+        if (filter->m_column[i])
+          translate_cell(cell, pos-cell, i-skip, row, numericals, strings);
+      }
+      else skip++;
+      i++;
+      if (pos == eol) break;
+      cell=pos+1;
+      pos=(const char *)memchr(cell, sep, eol-cell);
+    }
+    while (1);
+    if ((status == 0) && (i < nbQuant)) status=-1;
+    // missing cells: values of a previously rejected row are erased
+    for (; i<nbQuant; i++) {
+      if (!m_loadQuantity[i]) { skip++; continue; }
+      const Quantity &readQ=m_quantities[i-skip];
+      if (readQ.m_format.at(0) == 'A') strings[readQ.m_index][row].clear();
+      else numericals[readQ.m_index][row]=0.;
+    }
+    *keep=passRow(*filter, row, numericals, strings);
+    if (!*keep) return status;
+    cell=line;
+    pos=first;
+    i=0;
+    skip=0;
   }
+  do {
+    if (pos == NULL) pos=eol;
+    if (i >= nbQuant) return 1;
+    if ((!selected) || (m_loadQuantity[i])) {
+      if ((!filter) || (!filter->m_column[i]))
+        translate_cell(cell, pos-cell, i-skip, row, numericals, strings);
+    }
+    else skip++;
+    i++;
+    if (pos == eol) break;
+    cell=pos+1;
+    pos=(const char *)memchr(cell, sep, eol-cell);
+  }
+  while (1);
+  return (i < nbQuant) ? -1 : 0;
+}
 
+/**********************************************************************/
+// sidecar index of text data, blocks of m_blockLines lines from m_filePos;
+// only used to skip blocks, rows are not read by number through it
+struct Catalog::TextIndex {
+  long m_size, m_time;        // size and modification time of text file
+  long m_filePos;             // position of first data line
+  long m_blockLines;          // lines per block (last one can be shorter)
+  long m_nbCol;               // number of columns in file
+  long m_sep;                 // separator of data lines
+  std::vector<long> m_offset; // first char of each block (from m_filePos),
+                              // then end of data
+  std::vector<long> m_lines;  // number of lines of each block
+  std::vector<char> m_clean;  // 1 if each line of block is a row with all
+                              // columns (no warning, no end of data)
+  std::vector<double> m_min, m_max; // range of values [block*m_nbCol+col]
+                              // (min > max if there is only NaN)
+  std::vector<char> m_nan;    // 1 if column has NaN or empty cell
+};
+
+static const char INDEX_MAGIC[8]={'C','A','T','I','D','X','1','\n'};
+static const long INDEX_HEAD=7; // longs after magic
+
+/**********************************************************************/
+// PRIVATE METHOD is only called by loadText
+bool Catalog::readIndex(const TextView &file, const int nbQuant,
+                        TextIndex *index) const {
+
+  if ((file.isPacked()) || (file.m_time == 0)) return false;
+  std::ifstream in((file.m_name+".cidx").c_str(),
+                   std::ios::in | std::ios::binary);
+  if ( !in.is_open() ) return false;
+  char magic[8];
+  long head[INDEX_HEAD], nbBlocks;
+  in.read(magic, 8);
+  in.read((char *)head, sizeof(head));
+  if ((!in) || (memcmp(magic, INDEX_MAGIC, 8) != 0)) return false;
+  nbBlocks=head[6];
+  if ((head[0] != (long)file.m_size) || (head[1] != file.m_time)
+      || (head[2] != m_filePos) || (head[3] != m_textIndex)
+      || (head[4] != nbQuant) || (nbBlocks <= 0)
+      || (nbBlocks > (long)file.m_size)) return false;
+  // separator of first data line (as in loadText) must be the same
+  const char *line=file.m_data+m_filePos,
+             *end=file.m_data+file.m_size,
+             *eol;
+  char sep=0;
+  for (; line < end; line=eol+1) {
+    eol=(const char *)memchr(line, '\n', end-line);
+    if (eol == NULL) eol=end;
+    if ((eol == line) || (line[0] == 0x0D)) continue;
+    if (memchr(line, ';', eol-line) != NULL) sep=';';
+    else if (memchr(line, 0x09, eol-line) != NULL) sep=0x09;
+    break;
+  }
+  if (head[5] != sep) return false;
+  index->m_size=head[0];
+  index->m_time=head[1];
+  index->m_filePos=head[2];
+  index->m_blockLines=head[3];
+  index->m_nbCol=head[4];
+  index->m_sep=head[5];
+  const long nbCells=nbBlocks*nbQuant;
+  index->m_offset.resize(nbBlocks+1);
+  index->m_lines.resize(nbBlocks);
+  index->m_clean.resize(nbBlocks);
+  index->m_min.resize(nbCells);
+  index->m_max.resize(nbCells);
+  index->m_nan.resize(nbCells);
+  in.read((char *)&index->m_offset[0], (nbBlocks+1)*sizeof(long));
+  in.read((char *)&index->m_lines[0], nbBlocks*sizeof(long));
+  in.read(&index->m_clean[0], nbBlocks);
+  in.read((char *)&index->m_min[0], nbCells*sizeof(double));
+  in.read((char *)&index->m_max[0], nbCells*sizeof(double));
+  in.read(&index->m_nan[0], nbCells);
+  if (!in) return false;
+  if ((index->m_offset[0] != 0)
+      || (index->m_offset[nbBlocks] != (long)file.m_size-m_filePos))
+    return false;
+  for (long b=0; b<nbBlocks; b++)
+    if (index->m_offset[b+1] <= index->m_offset[b]) return false;
+  printLog(1, "Reading index file "+file.m_name+".cidx");
+  return true;
+}
+/**********************************************************************/
+// PRIVATE METHOD is only called by loadText (file must not be packed)
+void Catalog::buildIndex(const TextView &file, const char sep,
+                         const int nbQuant, TextIndex *index) const {
+
+  const char *begin=file.m_data+m_filePos,
+             *end=file.m_data+file.m_size,
+             *line, *eol;
+  long nbBlocks, nb=0;
+  index->m_size=file.m_size;
+  index->m_time=file.m_time;
+  index->m_filePos=m_filePos;
+  index->m_blockLines=m_textIndex;
+  index->m_nbCol=nbQuant;
+  index->m_sep=sep;
+  index->m_offset.clear();
+  index->m_lines.clear();
+  for (line=begin; line < end; line=eol+1) {
+    if (nb % m_textIndex == 0) {
+      index->m_offset.push_back(line-begin);
+      index->m_lines.push_back(0);
+    }
+    index->m_lines.back()++;
+    nb++;
+    eol=(const char *)memchr(line, '\n', end-line);
+    if (eol == NULL) break;
+  }
+  index->m_offset.push_back(end-begin);
+  nbBlocks=index->m_lines.size();
+  index->m_clean.assign(nbBlocks, 1);
+  index->m_min.assign(nbBlocks*nbQuant, HUGE_VAL);
+  index->m_max.assign(nbBlocks*nbQuant, -HUGE_VAL);
+  index->m_nan.assign(nbBlocks*nbQuant, 0);
+
+  // same tests and conversions as loadText(), blocks shared by threads
+  auto scan=[begin, sep, nbQuant, index](long b, const long step) {
+    for (; b < (long)index->m_lines.size(); b+=step) {
+      const char *next=begin+index->m_offset[b],
+                 *stop=begin+index->m_offset[b+1],
+                 *line, *eol, *cell, *pos;
+      double *low=&index->m_min[b*nbQuant],
+             *up =&index->m_max[b*nbQuant];
+      char   *nan=&index->m_nan[b*nbQuant];
+      int col, length;
+      for (line=next; line < stop; line=next) {
+        eol=(const char *)memchr(line, '\n', stop-line);
+        if (eol == NULL) { eol=stop; next=stop; }
+        else next=eol+1;
+        length=eol-line;
+        if ((length < 2) || (line[0] == 0x0D)
+            || ((length >= 6) && (strncmp(line, "#Table", 6) == 0))) {
+          index->m_clean[b]=0;
+          continue;
+        }
+        if (line[length-1] == 0x0D) length--;
+        eol=line+length;
+        for (col=0, cell=line; ; col++, cell=pos+1) {
+          pos=(const char *)memchr(cell, sep, eol-cell);
+          if (pos == NULL) pos=eol;
+          if (col < nbQuant) {
+            int size=pos-cell;
+            while ((size > 0) && (cell[size-1] == ' ')) size--;
+            double value= (size) ? textNumber(cell, size, false) : MissNAN;
+            if (value != value) nan[col]=1; // NaN
+            else {
+              if (value < low[col]) low[col]=value;
+              if (value > up[col]) up[col]=value;
+            }
+          }
+          if (pos == eol) break;
+        }
+        // one cell: line without separator
+        if ((col == 0) || (col+1 != nbQuant)) index->m_clean[b]=0;
+      }
+    }
+  };
+  int i, nbThreads=m_textThreads;
+  if (nbThreads == 0) nbThreads=std::thread::hardware_concurrency();
+  if (nbThreads > nbBlocks) nbThreads=nbBlocks;
+  if (nbThreads < 2) { scan(0, 1); return; }
+  std::vector<std::thread> workers;
+  for (i=0; i<nbThreads; i++) workers.push_back(std::thread(scan, i, nbThreads));
+  for (i=0; i<nbThreads; i++) workers[i].join();
+}
+/**********************************************************************/
+// PRIVATE METHOD is only called by loadText
+void Catalog::writeIndex(const std::string &fileName,
+                         const TextIndex &index) const {
+
+  const std::string name=fileName+".cidx",
+                    temp=name+".tmp";
+  const long nbBlocks=index.m_lines.size(),
+             nbCells=index.m_min.size();
+  if (nbBlocks == 0) return;
+  long head[INDEX_HEAD]={index.m_size, index.m_time, index.m_filePos,
+               index.m_blockLines, index.m_nbCol, index.m_sep, nbBlocks};
+  std::ofstream out(temp.c_str(),
+                    std::ios::out | std::ios::binary | std::ios::trunc);
+  if ( !out.is_open() ) {
+    printLog(1, "Index file "+name+" cannot be written");
+    return;
+  }
+  out.write(INDEX_MAGIC, 8);
+  out.write((const char *)head, sizeof(head));
+  out.write((const char *)&index.m_offset[0], (nbBlocks+1)*sizeof(long));
+  out.write((const char *)&index.m_lines[0], nbBlocks*sizeof(long));
+  out.write(&index.m_clean[0], nbBlocks);
+  out.write((const char *)&index.m_min[0], nbCells*sizeof(double));
+  out.write((const char *)&index.m_max[0], nbCells*sizeof(double));
+  out.write(&index.m_nan[0], nbCells);
+  out.close();
+  // renamed when complete: a partial index is never read
+  if ((!out) || (std::rename(temp.c_str(), name.c_str()) != 0)) {
+    std::remove(temp.c_str());
+    printLog(1, "Index file "+name+" cannot be written");
+    return;
+  }
+  printLog(1, "Index file "+name+" written");
+}
+/**********************************************************************/
+// PRIVATE METHOD only called while loading rows of importSelected:
+// same tests as checkNUM on the range of each column with criteria
+bool Catalog::skipBlock(const TextIndex &index, const long block,
+                        const RowFilter &filter) const {
+
+  if (!index.m_clean[block]) return false;
+  for (int i=0; i<(int)filter.m_quant.size(); i++) {
+    const Quantity &readQ=m_quantities[filter.m_quant[i]];
+    if ((readQ.m_type != Quantity::NUM) || (filter.m_fileCol[i] < 0))
+      continue;
+    // with cuts ORed, a value in list passes whatever the interval
+    if ((readQ.m_cutORed) && (readQ.m_listValN.size() > 0)) continue;
+    const long k=block*index.m_nbCol+filter.m_fileCol[i];
+    if ((index.m_nan[k]) && (!readQ.m_rejectNaN)) continue;
+    if (index.m_min[k] > index.m_max[k]) return true; // only NaN
+    if ((readQ.m_lowerCut < NO_SEL_CUT)
+        && (index.m_max[k] < readQ.m_lowerCut)) return true;
+    if ((readQ.m_upperCut < NO_SEL_CUT)
+        && (index.m_min[k] > readQ.m_upperCut)) return true;
+  }
+  return false;
 }
 
 /**********************************************************************/
@@ -55,17 +987,15 @@ void Catalog::translate_cell(std::string mot, const int index) {
    read the catalog header from CDS text file
 */
 int Catalog::analyze_head(unsigned long *tot, int *what, bool *testCR,
-                          std::fstream *myFile) {
+                          std::istream *myFile) {
 
   std::string text, mot;
-  unsigned int pos;
-  char line[MAX_LINE];
+  std::string::size_type pos;
   int  i, last,
        found=0,
        err=IS_OK;
 
-  // must use good instead eof, because eof is still false
-  // if getline reads MAX_LINE char ==> infinite loop
+  // lines of any length are read in text (capacity kept between lines)
   m_catName="";   m_catRef ="";
   m_tableName=""; m_tableRef ="";
   myFile->clear();  
@@ -73,8 +1003,7 @@ int Catalog::analyze_head(unsigned long *tot, int *what, bool *testCR,
   while ( myFile->good() ) {
 
     // extract line with delimiter \n which is discarded
-    myFile->getline(line, MAX_LINE);
-    text=line; /* convert C string to C++ string */
+    std::getline(*myFile, text);
     if (*tot == 0) {
       pos=text.find(' ');
       if (pos != std::string::npos) {
@@ -234,7 +1163,7 @@ int Catalog::analyze_head(unsigned long *tot, int *what, bool *testCR,
     }
     #ifdef DEBUG_CAT
     std::cout << *tot <<",";
-    if (*tot < 60ul) std::cout << line <<"|\n";
+    if (*tot < 60ul) std::cout << text <<"|\n";
     #endif
     err=-1*found;
     if (*what < 2) {
@@ -257,26 +1186,24 @@ int Catalog::analyze_head(unsigned long *tot, int *what, bool *testCR,
    if getDescr is true, otherwise read row data)
 */
 int Catalog::analyze_body(unsigned long *tot, int *what, const bool testCR,
-                     const bool getDescr, std::fstream *myFile, long *maxRows){
+                          const bool getDescr, std::istream *myFile) {
 
-  std::string  origin, text, mot;
-  unsigned int pos;
-  char sep=';',
-       line[MAX_LINE];
+  std::string  origin, text, mot,
+               line; // no length limit, capacity kept between lines
+  std::string::size_type pos;
+  char sep=';';
   std::ostringstream sortie;
-  bool foundColumn=false,
-       lineSkipped=false;
+  bool foundColumn=false;
   int  i, last, err=IS_OK,
        found=0,
-       nbQuantNum=0,
-       maxLine=MAX_LINE-1; // to avoid computation each line
+       nbQuantNum=0;
   int (*pfunc)(int)=toupper; // function used by transform
 
   if (getDescr) origin="importDescription"; else origin="import";
   while ( myFile->good() ) {
 
     // extract line with delimiter \n which is discarded
-    myFile->getline(line, MAX_LINE);
+    std::getline(*myFile, line);
     (*tot)++;
     switch (found) {
     case 0:
@@ -386,8 +1313,8 @@ int Catalog::analyze_body(unsigned long *tot, int *what, const bool testCR,
 
     case 2:
       // most of decription is read, units on separate line
-      last=strlen(line);
-      if (testCR) line[--last]='\0';
+      last=line.length();
+      if ((testCR) && (last > 0)) line.erase(--last);
       if (last > 0) {
         found++;
         text=line; /* convert C string to C++ string */
@@ -420,94 +1347,15 @@ int Catalog::analyze_body(unsigned long *tot, int *what, const bool testCR,
 
     case 3:
       // decription is read, separation line starting with ---
-      last=strlen(line);
-      if (testCR) line[--last]='\0';
+      last=line.length();
+      if ((testCR) && (last > 0)) line.erase(--last);
       if ((last > 0) && (line[0] == '-')) {
         found++;
         m_numRows=0;
         m_filePos=myFile->tellg();
-        if (getDescr) break; // must NOT read all file and create tables
-        if ( !*maxRows ) {
-          // read the total number of rows to have a maximal value
-          // to allocate m_strings, m_numericals buffers.
-          while ( myFile->good() ) {
-            myFile->getline(line, MAX_LINE);
-            if (strlen(line) < 2) break; // 1 CR for WINDOWS
-            (*maxRows)++;
-          }
-          // go back to initial position printf("%ld ReadRows\n", *maxRows);
-          myFile->clear(); // needed to reset flags before seekg
-          myFile->seekg(m_filePos);
-          m_numOriRows=*maxRows; // used by importSelected();
-        }
-        create_tables(nbQuantNum, *maxRows);
+        // data rows are read by loadText()
       }
       break;
-
-    default:
-      last=strlen(line);
-      if ((last == 0) || (line[0] == 0x0D)) {
-        lineSkipped=true; // to have Warning messages below
-        break;
-      }
-      // string max size is MAX_LINE-1;
-      if (last >= maxLine) {
-        sortie << "line #" << *tot << " exceeds maximal size ("
-               << MAX_LINE << ")";
-        printErr(origin, sortie.str());
-        sortie.str(""); // Will empty the string.
-        err=BAD_FILELINE;
-        break;
-      }
-      i=strncmp(line, "#Table", 6);
-      if (i == 0) {
-        sortie << "line #" << *tot << ": second table start (not read)";
-        printWarn(origin, sortie.str());
-        sortie.str(""); // Will empty the string.
-        err=BAD_ROW;
-        break;
-      }
-      if (testCR) line[--last]='\0';
-      text=line; /* convert C string to C++ string */
-      pos=text.find(sep);
-      if (pos == std::string::npos) {
-        sortie << "line #" << *tot << " without separator, line skipped";
-        printWarn(origin, sortie.str());
-        sortie.str(""); // Will empty the string.
-        break;
-      }
-      if ((m_numRows == *maxRows) || lineSkipped) {
-        err=BAD_ROW;
-        break;
-      }
-      i=0;
-      err=m_quantities.size();
-      do {
-        mot=text.substr(0, pos);
-        if (i < err) translate_cell(mot, i);
-        else {
-          sortie << "line #" << *tot << " contains too many quantities";
-          printWarn(origin, sortie.str());
-          sortie.str(""); // Will empty the string.
-          break;
-        }
-        i++;
-        if (pos != std::string::npos) {
-          text.erase(0, pos+1);
-          pos=text.find(sep);
-        }
-        else break;
-      }
-      while (1);
-      if (i <  err) {
-        sortie << "line #" << *tot << " does not contain all quantities";
-        printWarn(origin, sortie.str());
-        sortie.str(""); // Will empty the string.
-      }
-      err=IS_OK;
-      m_numRows++;
-      //found++;
-      break;
     }
     // to have only 1 test when reading all file
     if (found < 4) {
@@ -519,147 +1367,482 @@ int Catalog::analyze_body(unsigned long *tot, int *what, const bool testCR,
                        // found changed, no error on META ALL
       }
     }
-    else if (getDescr) break;
-    else if (err == BAD_ROW) break; // just stop, error not taken into account
+    else break;
 
   }// loop on file lines
-  //only possible errors: BAD_FILELINE or BAD_ROW
-  if (err == BAD_ROW) err=IS_OK;
-  else if (err == BAD_FILELINE) return err;
-  else if (found < 4) return (-1*found);
+  if (found < 4) return (-1*found);
   
   return err;
 }
 
 
 /**********************************************************************/
-/* PRIVATE METHOD is called by: importSelected() in "catalog_io.cxx"  */
-int Catalog::loadSelected(unsigned long *tot, std::fstream *myFile,
-                          long *maxRows) {
+/* PRIVATE METHOD is called by: load() and importSelected() in "catalog_io.cxx"
+   read the data rows from m_filePos; the file is mapped in memory
+   (or uncompressed by blocks of whole lines), lines and cells are
+   found with memchr and given to translate_cell() without any copy
+*/
+int Catalog::loadText(TextView &file, char sep, const bool selected,
+                      unsigned long *tot, long *maxRows) {
 
-  const std::string origin="importSelected";
-  int  i, last,
-       maxLine=MAX_LINE-1, // to avoid computation each line
-       err=0;
-  char sep=';',
-       line[MAX_LINE];
-
-  if ( !m_numOriRows ) {
-    // read the total number of rows to have a maximal value
-    // to allocate m_strings, m_numericals buffers.
-    while ( myFile->good() ) {
-      myFile->getline(line, MAX_LINE);
-      if (strlen(line) < 2) break; // 1 CR for WINDOWS
-      m_numOriRows++;
+  std::string origin="import",
+              prefix="line #";
+  if (selected) { origin="importSelected"; prefix="data line #"; }
+  std::ostringstream sortie;
+  const char *next=NULL, *end=NULL,
+             *line, *eol;
+  // whole data if file is in memory, otherwise first block of lines
+  if ((m_filePos >= 0)
+      && (file.pubseekpos(m_filePos, std::ios_base::in)
+          == std::streampos(m_filePos)))
+    file.nextLines(&next, &end);
+  int  i, nbQuant, nbNum=0, length,
+       err=IS_OK;
+  long nbLines=0;  // lines before first empty line: whole number of rows
+  bool grow=false, // true if number of rows is unknown
+       lineSkipped=false;
+
+  // rows limited by the caller: only the needed lines are parsed
+  const bool limited=(*maxRows > 0);
+  if ( !*maxRows ) {
+    if ((selected) && (m_numOriRows)) *maxRows=m_numOriRows;
+    else {
+      // tables grow geometrically while reading file (no pre-reading),
+      // unused rows are erased by the caller
+      grow=true;
+      *maxRows=(end-next)/16+1;
+      if (*maxRows > 1024) *maxRows=1024;
     }
-    // go back to initial position
-    myFile->clear(); // needed to reset flags before seekg
-    myFile->seekg(m_filePos);
-  }
-  last=m_quantities.size();
-  for (i=0; i<last; i++)
-    if (m_quantities[i].m_type == Quantity::NUM) err++;
-//std::cout << m_numOriRows << " OriRows" << std::endl;
+  }
+  nbQuant=m_quantities.size();
+  for (i=0; i<nbQuant; i++)
+    if (m_quantities[i].m_type == Quantity::NUM) nbNum++;
+  if (selected) nbQuant=m_loadQuantity.size();
   m_numRows=0;
-  if ( !*maxRows ) *maxRows=m_numOriRows;
-  if ( !m_numOriRows ) return IS_OK;
+  create_tables(nbNum, *maxRows);
+  // rows failing criteria of importSelected are not kept
+  RowFilter  cuts;
+  RowFilter *filter=NULL;
+  if ((selected) && (init_filter(&cuts))) filter=&cuts;
+  bool keep;
+  // blocks of sidecar index without rows passing the criteria are skipped
+  TextIndex  blocks;
+  TextIndex *index=NULL;
+  const char *start=next;  // data start if file is in memory
+  long nbRead=0,           // lines read from start
+       report=0,           // nbRead of next progress report
+       bytes=m_filePos;    // bytes read
+  bool knownIndex= (m_textIndex > 0) && (readIndex(file, nbQuant, &blocks));
+  if ((knownIndex) && (filter)) index=&blocks;
+
+  // large data parsed in parallel when the separator is known
+  int nbThreads=m_textThreads;
+  if (nbThreads == 0) nbThreads=std::thread::hardware_concurrency();
+  long nbChunks=(end-next)/TEXT_CHUNK;
+  if (nbChunks > nbThreads) nbChunks=nbThreads;
+  if ((file.isPacked()) || (limited)) nbChunks=0;
+  bool parallel=false;
+  if (nbChunks > 1) {
+    // separator of first data line, as below
+    for (line=next; (!sep) && (line < end); line=eol+1) {
+      eol=(const char *)memchr(line, '\n', end-line);
+      if (eol == NULL) eol=end;
+      if ((eol == line) || (line[0] == 0x0D)) continue;
+      if (memchr(line, ';', eol-line) != NULL) sep=';';
+      else if (memchr(line, 0x09, eol-line) != NULL) sep=0x09;
+      break;
+    }
+    if ((index) && (index->m_sep != sep)) index=NULL;
+    if (sep) {
+      parallel=true;
+      err=loadParallel(next, end, sep, selected, filter, index, grow,
+                       nbChunks, tot, maxRows);
+    }
+  }
 
-  create_tables(err, *maxRows);
-  bool testCR=false,
-       first=true,
-       lineSkipped=false;
-  unsigned int pos;
-  std::ostringstream sortie;
-  std::string text, mot;
+  while (!parallel) {
 
-  err=IS_OK;
-  while ( myFile->good() ) {
-
-    // extract line with delimiter \n which is discarded
-    myFile->getline(line, MAX_LINE);
+    if (nbRead >= report) {
+      report=nbRead+4096;
+      if (!importGoesOn(m_numRows, bytes)) { err=IMPORT_CANCEL; break; }
+    }
+    if ((index) && (nbRead % m_textIndex == 0) && (!lineSkipped)
+        && (sep == index->m_sep)) {
+      const long b=nbRead/m_textIndex;
+      if ((b < (long)index->m_lines.size())
+          && (next == start+index->m_offset[b])
+          && (skipBlock(*index, b, *filter))) {
+        next=start+index->m_offset[b+1];
+        bytes+=index->m_offset[b+1]-index->m_offset[b];
+        nbRead+=index->m_lines[b];
+        *tot+=index->m_lines[b];
+        if (nbLines >= 0) nbLines+=index->m_lines[b];
+        continue;
+      }
+    }
+    if (next >= end) {
+      if (file.nextLines(&next, &end)) continue;
+      // as getline, an empty line is read after last LF
+      if ((file.m_size == 0) || (file.m_last == '\n')) (*tot)++;
+      if (file.failed()) {
+        printErr(origin, "compressed data cannot be read until end of file");
+        err=BAD_FILETYPE;
+      }
+      break;
+    }
+    line=next;
+    eol=(const char *)memchr(line, '\n', end-line);
+    if (eol == NULL) { eol=end; next=end; }
+    else next=eol+1;
+    length=eol-line;
+    bytes+=next-line;
     (*tot)++;
-    last=strlen(line);
-    if ((last == 0) || (line[0] == 0x0D)) {
+    nbRead++;
+    if (nbLines >= 0) {
+      if (length < 2) nbLines=-1-nbLines; // 1 CR for WINDOWS
+      else nbLines++;
+    }
+    if ((length == 0) || (line[0] == 0x0D)) {
       lineSkipped=true; // to have Warning messages below
       continue;
     }
-    // string max size is MAX_LINE-1;
-    if (last >= maxLine) {
-      sortie << "data line #" << *tot << " exceeds maximal size ("
-             << MAX_LINE << ")";
-      printErr(origin, sortie.str());
-      err=BAD_FILELINE;
-      break;
-    }
-    if (first) {
-      first=false;
-      // test if last char is CR from WINDOWS
-      if (line[last-1] == 0x0D) testCR=true;
-      char *posC=strchr(line, sep);
-      // if separator isn't the default ; search for TAB
+    if (!sep) {
+      // separator of first data line: default ; otherwise TAB
       // suppose there is at least 2 columns
-      if (posC == NULL) {
-        posC=strchr(line, 0x09);
-        if (posC != NULL) sep=0x09;
-        else {
-          printErr(origin, "first data line has no separator");
-          err=BAD_FILETYPE;
-          break;
-        }
+      if (memchr(line, ';', length) != NULL) sep=';';
+      else if (memchr(line, 0x09, length) != NULL) sep=0x09;
+      else {
+        printErr(origin, "first data line has no separator");
+        err=BAD_FILETYPE;
+        break;
       }
     }
-    else if (testCR) line[--last]='\0';
-    i=strncmp(line, "#Table", 6);
-    if (i == 0) {
-      sortie << "data line #" << *tot << ": second table start (not read)";
+    if ((length >= 6) && (strncmp(line, "#Table", 6) == 0)) {
+      sortie << prefix << *tot << ": second table start (not read)";
       printWarn(origin, sortie.str());
       sortie.str(""); // Will empty the string.
       break;
     }
-    text=line; /* convert C string to C++ string */
-    pos=text.find(sep);
-    if (pos == std::string::npos) {
-      sortie << "data line #" << *tot << " without separator, line skipped";
+    // test if last char is CR from WINDOWS
+    if (line[length-1] == 0x0D) length--;
+    eol=line+length;
+    const char *pos=(const char *)memchr(line, sep, length);
+    if (pos == NULL) {
+      sortie << prefix << *tot << " without separator, line skipped";
       printWarn(origin, sortie.str());
       sortie.str(""); // Will empty the string.
       continue;
     }
-    i=0;
     if (lineSkipped) break;
-    err=m_loadQuantity.size();
-    last=0;
-    do {
-      mot=text.substr(0, pos);
-      if (i >= err) {
-        sortie << "data line #" << *tot << " contains too many quantities";
+    if (m_numRows == *maxRows) {
+      if (!grow) break;
+      *maxRows*=2;
+      add_rows(*maxRows);
+    }
+    i=split_row(line, eol, pos, sep, nbQuant, selected, m_numRows,
+                m_numericals, m_strings, filter, &keep);
+    if (i > 0) {
+      sortie << prefix << *tot << " contains too many quantities";
+      printWarn(origin, sortie.str());
+      sortie.str(""); // Will empty the string.
+    }
+    else if (i < 0) {
+      sortie << prefix << *tot << " does not contain all quantities";
+      printWarn(origin, sortie.str());
+      sortie.str(""); // Will empty the string.
+    }
+    if (keep) m_numRows++;
+  }
+  if ((err == IS_OK) && (!parallel) && (!importGoesOn(m_numRows, bytes)))
+    err=IMPORT_CANCEL;
+  if ((grow) && (!parallel) && (err != IMPORT_CANCEL)) {
+    if (nbLines < 0) nbLines=-1-nbLines;
+    m_numOriRows=nbLines; // used by importSelected();
+  }
+  // index written by the first import of an unchanged file
+  if ((err == IS_OK) && (m_textIndex > 0) && (!knownIndex) && (sep)
+      && (m_filePos >= 0) && (!file.isPacked()) && (file.m_time)) {
+    buildIndex(file, sep, nbQuant, &blocks);
+    writeIndex(file.m_name, blocks);
+  }
+  return err;
+}
+/**********************************************************************/
+// part of text data parsed by one thread
+struct Catalog::TextChunk {
+  const char *m_begin, *m_end;   // first char, after last LF
+  long m_numRows;                // rows loaded in tables below
+  long m_block;                  // first block of index at m_begin
+  std::atomic<long> m_readBytes, m_readRows; // progress of parsing
+  std::vector<unsigned char> m_lines; // LINE_* bits of each line read
+  std::vector<std::vector<double> > m_numericals;
+  std::vector<std::vector<std::string> > m_strings;
+  std::string m_error;           // exception text, empty if none
+  TextChunk() : m_readBytes(0), m_readRows(0) {}
+};
+
+/**********************************************************************/
+/* PRIVATE METHOD is only called by loadParallel (one thread per chunk)
+   same parsing as loadText() in chunk tables; the lines are only
+   classified, warnings are given when chunks are put together
+*/
+void Catalog::parseChunk(const char sep, const bool selected,
+                         const RowFilter *filter, const TextIndex *index,
+                         TextChunk *chunk) const {
+
+  const char *next=chunk->m_begin, *end=chunk->m_end,
+             *line, *eol, *pos;
+  int  i, length,
+       nbQuant= (selected) ? m_loadQuantity.size() : m_quantities.size();
+  long maxRows=(end-next)/64+16,
+       nbRead=0, // lines read in chunk
+       report=0; // nbRead of next progress update
+  unsigned char kind;
+  bool lineSkipped=false,
+       keep;
+
+  chunk->m_numRows=0;
+  chunk->m_numericals.resize(m_numericals.size());
+  chunk->m_strings.resize(m_strings.size());
+  for (i=0; i<(int)m_numericals.size(); i++)
+    chunk->m_numericals[i].resize(maxRows);
+  for (i=0; i<(int)m_strings.size(); i++) chunk->m_strings[i].resize(maxRows);
+  for (line=next; line < end; line=next) {
+    if (nbRead >= report) {
+      report=nbRead+4096;
+      chunk->m_readBytes=line-chunk->m_begin;
+      chunk->m_readRows=chunk->m_numRows;
+      if ((m_async) && (m_cancel)) break;
+    }
+    if ((index) && (nbRead % m_textIndex == 0) && (!lineSkipped)) {
+      // lines of a skipped block are rows failing the criteria
+      const long b=chunk->m_block+nbRead/m_textIndex;
+      if ((b < (long)index->m_lines.size())
+          && (line-chunk->m_begin
+              == index->m_offset[b]-index->m_offset[chunk->m_block])
+          && (skipBlock(*index, b, *filter))) {
+        chunk->m_lines.insert(chunk->m_lines.end(), index->m_lines[b],
+                              LINE_ROW | LINE_CUT);
+        next=line+(index->m_offset[b+1]-index->m_offset[b]);
+        nbRead+=index->m_lines[b];
+        continue;
+      }
+    }
+    eol=(const char *)memchr(line, '\n', end-line);
+    if (eol == NULL) { eol=end; next=end; }
+    else next=eol+1;
+    length=eol-line;
+    nbRead++;
+    kind= (length < 2) ? LINE_SHORT : 0;
+    if ((length == 0) || (line[0] == 0x0D)) {
+      chunk->m_lines.push_back(kind | LINE_EMPTY);
+      lineSkipped=true;
+      continue;
+    }
+    if ((length >= 6) && (strncmp(line, "#Table", 6) == 0)) {
+      chunk->m_lines.push_back(kind | LINE_TABLE);
+      break;
+    }
+    if (line[length-1] == 0x0D) length--;
+    eol=line+length;
+    pos=(const char *)memchr(line, sep, length);
+    if (pos == NULL) {
+      chunk->m_lines.push_back(kind | LINE_NOSEP);
+      continue;
+    }
+    kind|=LINE_ROW;
+    // end of data: the row is not loaded
+    if (lineSkipped) { chunk->m_lines.push_back(kind); break; }
+    if (chunk->m_numRows == maxRows) {
+      maxRows*=2;
+      for (i=0; i<(int)m_numericals.size(); i++)
+        chunk->m_numericals[i].resize(maxRows);
+      for (i=0; i<(int)m_strings.size(); i++)
+        chunk->m_strings[i].resize(maxRows);
+    }
+    i=split_row(line, eol, pos, sep, nbQuant, selected, chunk->m_numRows,
+                chunk->m_numericals, chunk->m_strings, filter, &keep);
+    if (i > 0) kind|=LINE_MANY;
+    else if (i < 0) kind|=LINE_FEW;
+    if (!keep) kind|=LINE_CUT;
+    chunk->m_lines.push_back(kind);
+    if (keep) chunk->m_numRows++;
+  }
+}
+
+/**********************************************************************/
+/* PRIVATE METHOD is only called by loadText
+   data between begin and end are cut in nbChunks parts ending with LF,
+   each part is parsed by one thread; then lines are checked in file
+   order (to stop at the same row and to give the same warnings as a
+   sequential reading) and rows are copied to the tables
+*/
+int Catalog::loadParallel(const char *begin, const char *end, const char sep,
+                          const bool selected, const RowFilter *filter,
+                          const TextIndex *index, const bool grow,
+                          int nbChunks,
+                          unsigned long *tot, long *maxRows) {
+
+  std::string origin="import",
+              prefix="line #";
+  if (selected) { origin="importSelected"; prefix="data line #"; }
+  std::ostringstream sortie;
+  std::vector<TextChunk> chunks(nbChunks);
+  const char *cut=begin, *eol;
+  long size=(end-begin)/nbChunks,
+       nbLines=0, // lines before first empty line: whole number of rows
+       k, nb;
+  int  i, j;
+  bool lineSkipped=false,
+       stop=false;
+
+  long block=0;
+  for (i=0; (i < nbChunks) && (cut < end); i++) {
+    chunks[i].m_begin=cut;
+    chunks[i].m_block=block;
+    eol=NULL;
+    if ((i < nbChunks-1) && (cut+size < end)) {
+      if (index) {
+        // chunks start with a block of the index
+        std::vector<long>::const_iterator at=std::lower_bound(
+          index->m_offset.begin()+block, index->m_offset.end()-1,
+          (cut-begin)+size);
+        block=at-index->m_offset.begin();
+        if (at != index->m_offset.end()-1) eol=begin+(*at)-1;
+      }
+      else eol=(const char *)memchr(cut+size, '\n', end-cut-size);
+    }
+    cut= (eol == NULL) ? end : eol+1;
+    chunks[i].m_end=cut;
+  }
+  nbChunks=i;
+  std::mutex lock;
+  std::condition_variable finished;
+  int  running=nbChunks;
+  std::vector<std::thread> workers;
+  for (i=0; i<nbChunks; i++) workers.push_back(std::thread(
+    [this, sep, selected, filter, index, &lock, &finished, &running]
+    (TextChunk *chunk) {
+      try { parseChunk(sep, selected, filter, index, chunk); }
+      catch (const std::exception &prob) {
+        chunk->m_error=prob.what();
+        if (chunk->m_error.empty()) chunk->m_error="unknown";
+      }
+      chunk->m_readBytes=chunk->m_end-chunk->m_begin;
+      chunk->m_readRows=chunk->m_numRows;
+      std::lock_guard<std::mutex> guard(lock);
+      running--;
+      finished.notify_one();
+    }, &chunks[i]));
+  // progress of all chunks reported until they are parsed
+  long rows, bytes;
+  std::unique_lock<std::mutex> guard(lock);
+  do {
+    guard.unlock();
+    rows=0;
+    bytes=m_filePos;
+    for (i=0; i<nbChunks; i++) {
+      rows+=chunks[i].m_readRows;
+      bytes+=chunks[i].m_readBytes;
+    }
+    importGoesOn(rows, bytes);
+    guard.lock();
+  } while ((m_async) && (!finished.wait_for(guard,
+             std::chrono::milliseconds(100), [&running]() {
+               return running == 0;
+             })));
+  guard.unlock();
+  for (i=0; i<nbChunks; i++) workers[i].join();
+  for (i=0; i<nbChunks; i++) {
+    if (chunks[i].m_error.empty()) continue;
+    std::string errText="EXCEPTION parsing text data: "+chunks[i].m_error;
+    printErr(origin, errText);
+    throw std::runtime_error(errText);
+  }
+  if ((m_async) && (m_cancel)) return IMPORT_CANCEL;
+
+  // same tests as sequential loadText(), in file order
+  std::vector<long> nbRows(nbChunks, 0);
+  m_numRows=0;
+  for (i=0; (i < nbChunks) && (!stop); i++) {
+    std::vector<unsigned char>::const_iterator kind;
+    for (kind=chunks[i].m_lines.begin(); kind != chunks[i].m_lines.end();
+         ++kind) {
+      (*tot)++;
+      if (nbLines >= 0) {
+        if (*kind & LINE_SHORT) nbLines=-1-nbLines; // 1 CR for WINDOWS
+        else nbLines++;
+      }
+      if (*kind & LINE_EMPTY) {
+        lineSkipped=true; // to have Warning messages below
+        continue;
+      }
+      if (*kind & LINE_TABLE) {
+        sortie << prefix << *tot << ": second table start (not read)";
         printWarn(origin, sortie.str());
         sortie.str(""); // Will empty the string.
+        stop=true;
         break;
       }
-      else {
-        if (m_loadQuantity[i]) translate_cell(mot, i-last);
-        else last++;
+      if (*kind & LINE_NOSEP) {
+        sortie << prefix << *tot << " without separator, line skipped";
+        printWarn(origin, sortie.str());
+        sortie.str(""); // Will empty the string.
+        continue;
       }
-      i++;
-      if (pos != std::string::npos) {
-        text.erase(0, pos+1);
-        pos=text.find(sep);
+      if ((lineSkipped) || ((!grow) && (m_numRows == *maxRows))) {
+        stop=true;
+        break;
       }
-      else break;
+      if (*kind & LINE_MANY) {
+        sortie << prefix << *tot << " contains too many quantities";
+        printWarn(origin, sortie.str());
+        sortie.str(""); // Will empty the string.
+      }
+      else if (*kind & LINE_FEW) {
+        sortie << prefix << *tot << " does not contain all quantities";
+        printWarn(origin, sortie.str());
+        sortie.str(""); // Will empty the string.
+      }
+      if (*kind & LINE_CUT) continue;
+      nbRows[i]++;
+      m_numRows++;
     }
-    while (1);
-    if (i <  err) {
-      sortie << "data line #" << *tot << " does not contain all quantities";
-      printWarn(origin, sortie.str());
-      sortie.str(""); // Will empty the string.
+  }
+  // as getline, an empty line is read after last LF
+  if ((!stop) && (end[-1] == '\n')) (*tot)++;
+
+  // rows copied in order, each chunk freed after its copy
+  if (grow) {
+    *maxRows=m_numRows;
+    add_rows(m_numRows);
+    if (nbLines < 0) nbLines=-1-nbLines;
+    m_numOriRows=nbLines; // used by importSelected();
+  }
+  k=0;
+  for (i=0; i<nbChunks; i++) {
+    TextChunk &chunk=chunks[i];
+    nb=nbRows[i];
+    for (j=0; j<(int)m_numericals.size(); j++) {
+      if (nb > 0) std::copy(chunk.m_numericals[j].begin(),
+                            chunk.m_numericals[j].begin()+nb,
+                            m_numericals[j].begin()+k);
+      std::vector<double>().swap(chunk.m_numericals[j]);
+    }
+    for (j=0; j<(int)m_strings.size(); j++) {
+      if (nb > 0) std::move(chunk.m_strings[j].begin(),
+                            chunk.m_strings[j].begin()+nb,
+                            m_strings[j].begin()+k);
+      std::vector<std::string>().swap(chunk.m_strings[j]);
     }
-    err=IS_OK;
-    m_numRows++;
+    k+=nb;
   }
-  return err;
+  if (!importGoesOn(m_numRows, m_filePos+(end-begin))) return IMPORT_CANCEL;
+  return IS_OK;
 }
 
 
+
 /**********************************************************************/
 // common code between importWeb and importDescriptionWeb (private method)
 int Catalog::loadWeb(const std::string catName, const std::string urlCode,
@@ -667,7 +1850,7 @@ int Catalog::loadWeb(const std::string catName, const std::string urlCode,
 
   std::string origin, text, web;
   int i, err;
-  unsigned int pos;
+  std::string::size_type pos;
   if (maxRow >= 0) origin="importWeb"; else origin="importDescriptionWeb";
 
   err=BAD_URL;
@@ -775,10 +1958,122 @@ int Catalog::importWeb(const std::string catName,
 }
 
 
+// size (bytes) of the text output buffered before each write on file
+static const size_t TEXT_OUTPUT=1 << 20;
+
+/**********************************************************************/
+// decodes a sprintf format "%[+][0]w[.p]f" of createText;
+// returns false for any other format (written by snprintf)
+static bool fixedFormat(const std::string &format, int *width,
+                        int *precision, bool *plus, bool *zero) {
+
+  const char *c=format.c_str();
+  if (*c++ != '%') return false;
+  *plus=false;
+  *zero=false;
+  for (; (*c == '+') || (*c == '0'); c++) {
+    if (*c == '+') *plus=true; else *zero=true;
+  }
+  if ((*c < '1') || (*c > '9')) return false;
+  for (*width=0; (*c >= '0') && (*c <= '9'); c++) {
+    if (*width > 999) return false;
+    *width=*width*10+(*c-'0');
+  }
+  *precision=6;
+  if (*c == '.') {
+    for (c++, *precision=0; (*c >= '0') && (*c <= '9'); c++) {
+      if (*precision > 99) return false;
+      *precision=*precision*10+(*c-'0');
+    }
+  }
+  return ((*c == 'f') && (c[1] == '\0'));
+}
+
 /**********************************************************************/
-// create catalog header from memory to a text file
+// writes value as sprintf("%[+][0]w.pf") in cell (width+48 char),
+// without the final '\0'; returns the number of char, or 0 when the
+// rounding of the last decimal is not certain (snprintf must be used).
+static int fixedNumber(const double value, const int width,
+                       const int precision, const bool plus, const bool zero,
+                       const char point, char *cell) {
+
+  if (precision > 15) return 0;
+  double scaled=std::fabs(value)*s_pow10[precision];
+  if (!(scaled < 1e15)) return 0;   // also for infinity
+  double whole=std::floor(scaled),
+         frac=scaled-whole;
+  // scaled has one rounding error: below 2^-52 relative
+  if (std::fabs(frac-0.5) <= scaled*2.3e-16) return 0;
+  unsigned long long mant=(unsigned long long)whole;
+  if (frac > 0.5) mant++;
+
+  char digits[24], *d=digits+sizeof(digits);
+  int  nbDigits=0;
+  do {
+    *--d='0'+(char)(mant%10ull);
+    mant/=10ull;
+    nbDigits++;
+  } while ((mant != 0ull) || (nbDigits <= precision));
+
+  char sign=0;
+  if (std::signbit(value)) sign='-'; else if (plus) sign='+';
+  int  length=nbDigits+(precision > 0)+(sign != 0),
+       pad= (width > length) ? width-length : 0;
+  char *c=cell;
+  if (!zero) for (; pad > 0; pad--) *c++=' ';
+  if (sign) *c++=sign;
+  for (; pad > 0; pad--) *c++='0';
+  std::memcpy(c, d, nbDigits-precision);
+  c+=nbDigits-precision;
+  if (precision > 0) {
+    *c++=point;
+    std::memcpy(c, d+nbDigits-precision, precision);
+    c+=precision;
+  }
+  return c-cell;
+}
+
+/**********************************************************************/
+// writes value in cell as the default operator<< of a stream ("%g" with
+// a '.' whatever the C locale); returns the number of char
+static int freeNumber(const double value, const char point,
+                      std::vector<char> &cell) {
+
+  int length=snprintf(&cell[0], cell.size(), "%g", value);
+  if (point != '.') {
+    char *c=(char *)std::memchr(&cell[0], point, length);
+    if (c != NULL) *c='.';
+  }
+  return length;
+}
+// same with the shortest "%.15g" to "%.17g" giving back the same double
+// (VECTOR elements, one column each); NaN is one blank
+static int exactNumber(const double value, const char point,
+                       std::vector<char> &cell) {
+
+  int length, digits=15;
+#ifdef WIN32
+  if (_isnan(value)) { cell[0]=' '; return 1; }
+#else
+  if (std::isnan(value)) { cell[0]=' '; return 1; }
+#endif
+  do {
+    length=snprintf(&cell[0], cell.size(), "%.*g", digits, value);
+  } while ((++digits <= 17) && (strtod(&cell[0], NULL) != value));
+  if (point != '.') {
+    char *c=(char *)std::memchr(&cell[0], point, length);
+    if (c != NULL) *c='.';
+  }
+  return length;
+}
+
+/**********************************************************************/
+// create catalog header from memory to a text file, with the
+// quantities of index cols only (in this order); each VECTOR element
+// is written in its own column NAME[k]
 int Catalog::createText(const std::string &fileName, bool clobber,
-                        const std::string origin) {
+                        const std::string origin,
+                        const std::vector<int> &quantCols) {
   std::string  text;
   int          err;
   std::ios_base::openmode openMode=std::ios::in;
@@ -814,67 +2109,114 @@ int Catalog::createText(const std::string &fileName, bool clobber,
     printErr(origin, text);
     return BAD_FILENAME;
   }
+  // "*.gz": text compressed by a second thread while rows are formatted
+  Packer packer;
+  const bool packed=Packer::wanted(fileName);
+  if (packed) {
+    file.close();
+    if ( !packer.open(fileName) ) {
+      text=": FILENAME \""+fileName+"\" cannot be written";
+      printErr(origin, text);
+      return BAD_FILENAME;
+    }
+  }
+  auto put=[&](std::string &block) {
+    if (packed) packer.write(block);
+    else file.write(block.data(), block.size());
+  };
 
   std::ostringstream sortie;
+  // VECTOR of unsupported format cannot be written
+  std::vector<int> cols;
+  for (size_t c=0; c<quantCols.size(); c++) {
+    const Quantity &readQ=m_quantities[quantCols[c]];
+    if ((readQ.m_type == Quantity::VECTOR) && (readQ.m_vectorQs.empty())) {
+      sortie << "VECTOR format " << readQ.m_format << " not supported, "
+             << "quantity '" << readQ.m_name << "' not written";
+      printWarn(origin, sortie.str() );
+      sortie.str("");
+    }
+    else cols.push_back(quantCols[c]);
+  }
+  if ( cols.empty() ) {
+    printErr(origin, ": no quantity can be written");
+    return BAD_QUANT_NAME;
+  }
   char tab=0x09, sep=';';
-  int  j, vecSize;
-  long tot=0l, totData=0l;
+  int  j, q, vecSize, nbQuant=m_quantities.size();
+  long tot=0l;
   bool saveAll=(origin == "saveText"),
        specialCOORD;
   if (m_numRows == m_numSelRows) saveAll=true;
 
-  file << "#RESOURCE=catalogAccess(" << m_code << ")" << std::endl;
-  file << "#Name: " << m_catName << std::endl;
-  file << "#Title:" << tab <<  m_catRef << std::endl;
-  file << "#Name: " << m_tableName << std::endl;
-  file << "#Title:" << tab <<  m_tableRef << std::endl;
+  std::ostringstream head;
+  head << "#RESOURCE=catalogAccess(" << m_code << ")" << std::endl;
+  head << "#Name: " << m_catName << std::endl;
+  head << "#Title:" << tab <<  m_catRef << std::endl;
+  head << "#Name: " << m_tableName << std::endl;
+  head << "#Title:" << tab <<  m_tableRef << std::endl;
   tot+=5;
-  vecSize=m_quantities.size();
+  vecSize=cols.size();
+  // names and units of the written columns (one per VECTOR element)
+  std::vector<std::string> names, units;
   for (j=0; j<vecSize; j++) {
+    q=cols[j];
+    if (m_quantities[q].m_type == Quantity::VECTOR) {
+      const std::vector<std::string> &elements=m_quantities[q].m_vectorQs;
+      for (size_t k=0; k<elements.size(); k++) {
+        head << "#Column" << tab << elements[k] << tab << "(1D)" << tab;
+        if (elements[k].length() < 8) head << "        ";
+        head << m_quantities[q].m_comment << tab << "[ucd="
+             << m_quantities[q].m_ucd << "]" << std::endl;
+        names.push_back(elements[k]);
+        units.push_back(m_quantities[q].m_unit);
+      }
+      continue;
+    }
     if ( m_URL.empty() )  { /* from binary fits */
-      text=m_quantities[j].m_format;
+      text=m_quantities[q].m_format;
       err=text.length();
-      if ((m_quantities[j].m_type == Quantity::STRING) ||
-          (m_quantities[j].m_type == Quantity::LOGICALS)) {
+      if ((m_quantities[q].m_type == Quantity::STRING) ||
+          (m_quantities[q].m_type == Quantity::LOGICALS)) {
         if (err > 1) text.erase(err-1); else text="1";
-        file << "#Column" << tab << m_quantities[j].m_name << tab << "(A"
+        head << "#Column" << tab << m_quantities[q].m_name << tab << "(A"
              << text << ")" << tab;
       }
       else {
         if (err == 1) text="1"+text;
-        file << "#Column" << tab << m_quantities[j].m_name << tab << "("
+        head << "#Column" << tab << m_quantities[q].m_name << tab << "("
              << text << ")" << tab;
       }
     }
     else {
-      file << "#Column" << tab << m_quantities[j].m_name << tab << "("
-           << m_quantities[j].m_format << ")" << tab;
+      head << "#Column" << tab << m_quantities[q].m_name << tab << "("
+           << m_quantities[q].m_format << ")" << tab;
     }
-    if (m_quantities[j].m_name.length() < 8) file << "        ";
-    file << m_quantities[j].m_comment << tab << "[ucd="
-         << m_quantities[j].m_ucd << "]"
+    if (m_quantities[q].m_name.length() < 8) head << "        ";
+    head << m_quantities[q].m_comment << tab << "[ucd="
+         << m_quantities[q].m_ucd << "]"
          << std::endl;
+    names.push_back(m_quantities[q].m_name);
+    units.push_back(m_quantities[q].m_unit);
   }
-  file << std::endl;
-  tot+=vecSize+1;
+  head << std::endl;
+  q=names.size();
+  tot+=q+1;
   // line do NOT end with separator
-  for (j=0; j<vecSize-1; j++) {
-    file << m_quantities[j].m_name << sep;
-  }
-  file << m_quantities[j].m_name << std::endl;
-  for (j=0; j<vecSize-1; j++) {
-    file << m_quantities[j].m_unit << sep;
-  }
-  file << m_quantities[j].m_unit << std::endl;
-  file << "---" << std::endl;
+  for (j=0; j<q-1; j++) head << names[j] << sep;
+  head << names[j] << std::endl;
+  for (j=0; j<q-1; j++) head << units[j] << sep;
+  head << units[j] << std::endl;
+  head << "---" << std::endl;
+  text=head.str();
+  put(text);
   tot+=3;
   try {
-    int i, len, bufSize=0;
-    char first, *buffer=NULL;
-    std::vector<std::string> formats(vecSize, "%s");
-    std::vector<int>         lengths(vecSize, 0);
-    double r;
-    for (i=0; i<vecSize; i++) { 
+    int i, bufSize=0;
+    char first=0;
+    std::vector<std::string> formats(nbQuant, "%s");
+    std::vector<int>         lengths(nbQuant, 0);
+    for (i=0; i<nbQuant; i++) { 
       text=m_quantities[i].m_format;
       j=text.length();
       if (j == 0) continue;
@@ -921,12 +2263,7 @@ int Catalog::createText(const std::string &fileName, bool clobber,
       j=std::atoi(text.c_str());
       if (j <= 0) continue;
       lengths[i]=j;
-      if (j > bufSize) {
-        bufSize=j;
-        buffer=(char *)realloc(buffer, bufSize*sizeof(char));
-        if (buffer == NULL)
-          throw std::runtime_error("Cannot allocate string buffer");
-      }
+      if (j > bufSize) bufSize=j;
       switch (first) {
       case 'A':
         sortie << "%" << j << "s";
@@ -955,98 +2292,190 @@ int Catalog::createText(const std::string &fileName, bool clobber,
           << formats[i] <<" ("<< j <<")"<< std::endl;*/
     }
     // all the quantities have their sprintf format
-    // IF their lengths[] is positive
-    if (saveAll) {
-
-      for (long k=0; k<m_numRows; k++) for (j=0; j<vecSize; ) {
-        if (m_quantities[j].m_type == Quantity::NUM) {
-          r=m_numericals[m_quantities[j].m_index].at(k);
+    // IF their lengths[] is positive; "%[+][0]w.pf" are written directly
+    std::vector<int>  widths(nbQuant, 0), precisions(nbQuant, -1);
+    std::vector<char> plus(nbQuant, 0), zero(nbQuant, 0);
+    for (i=0; i<nbQuant; i++) {
+      bool p, z;
+      if ((lengths[i] == 0) || (m_quantities[i].m_type != Quantity::NUM))
+        continue;
+      if (!fixedFormat(formats[i], &widths[i], &precisions[i], &p, &z)) {
+        precisions[i]=-1;
+        continue;
+      }
+      plus[i]=p;
+      zero[i]=z;
+    }
+    const char point=localeconv()->decimal_point[0];
+    const std::string blanks(bufSize+1, ' ');
+    // only the selected rows are visited (their indices in rows)
+    std::vector<long> rows;
+    if (!saveAll) selectedRows(&rows);
+    const long outRows= (saveAll) ? m_numRows : (long)rows.size();
+    // output rows begin to end-1 (selected ones if !saveAll)
+    auto formatRows=[&](const long begin, const long end,
+                        std::string &output) {
+      int    i, j, c, len;
+      double r;
+      // a cell is never longer than the largest %f of a double
+      std::vector<char> cell(bufSize+400);
+      for (long n=begin; n<end; n++) {
+        const long k= (saveAll) ? n : rows[n];
+        for (c=0; c<vecSize; c++) {
+          if (c > 0) output+=sep;
+          j=cols[c];
+          if (m_quantities[j].m_type == Quantity::NUM) {
+            r=m_numericals[m_quantities[j].m_index].at(k);
 #ifdef WIN32
-          if (_isnan(r)) {
+            if (_isnan(r)) {
 #else
-          if (std::isnan(r)) {
+            if (std::isnan(r)) {
 #endif
-            len=lengths[j];
-            if (len == 0) len=1;
-/*             file << std::setw(len+1) << std::setfill(' ');
-DOES NOT WORK*/
-            sortie << "%" << len << "s";
-            text=sortie.str();
-            sprintf(buffer, text.c_str(), "");
-            file.write(buffer, len);
-            sortie.str("");
+              len=lengths[j];
+              if (len == 0) len=1;
+              output.append(blanks, 0, len);
+            }
+            else if (lengths[j] > 0) {
+              // the cell is cut to its declared length, as before
+              len=0;
+              if (precisions[j] >= 0) len=fixedNumber(r, widths[j],
+                               precisions[j], plus[j], zero[j], point, &cell[0]);
+              if (len == 0) len=snprintf(&cell[0], cell.size(),
+                                         formats[j].c_str(), r);
+              if (len > lengths[j]) len=lengths[j];
+              output.append(&cell[0], len);
+            }
+            else {
+              len=freeNumber(r, point, cell);
+              output.append(&cell[0], len);
+            }
           }
-          else if (lengths[j] > 0) {
-            sprintf(buffer, formats[j].c_str(), r);
-            file.write(buffer, lengths[j]);
+          else if ((m_quantities[j].m_type == Quantity::STRING) ||
+                   (m_quantities[j].m_type == Quantity::LOGICALS)) {
+            const std::string &word=m_strings[m_quantities[j].m_index].at(k);
+            if (lengths[j] > 0) {
+              // as sprintf("%ws") cut to w char
+              len=std::strlen(word.c_str());
+              if (len < lengths[j]) output.append(blanks, 0, lengths[j]-len);
+              else len=lengths[j];
+              output.append(word.c_str(), len);
+            }
+            else output+=word;
           }
-          else file << r;
-        }
-        else if ((m_quantities[j].m_type == Quantity::STRING) ||
-                 (m_quantities[j].m_type == Quantity::LOGICALS)) {
-          text=m_strings[m_quantities[j].m_index].at(k);
-          if (lengths[j] > 0) {
-            sprintf(buffer, formats[j].c_str(), text.c_str());
-            file.write(buffer, lengths[j]);
+          else if (m_quantities[j].m_type == Quantity::VECTOR) {
+            /* one column per element, without precision loss */
+            int size=m_quantities[j].m_vectorQs.size();
+            const double *in=&m_vectors[m_quantities[j].m_index][k*size];
+            for (i=0; i<size; i++) {
+              if (i) output+=sep;
+              len=exactNumber(in[i], point, cell);
+              output.append(&cell[0], len);
+            }
           }
-          else file << text;
         }
-        if (++j == vecSize) file << std::endl; else file << sep;
-      } // loop on rows and quantities
-
+        output+='\n';
+      }
+    };
+
+    // rows are formatted by parts of about TEXT_OUTPUT bytes
+    long rowBytes=vecSize, partRows, nbParts, part;
+    for (j=0; j<vecSize; j++) {
+      rowBytes+=lengths[cols[j]];
+      if (m_quantities[cols[j]].m_type == Quantity::VECTOR)
+        rowBytes+=25*m_quantities[cols[j]].m_vectorQs.size();
     }
-    else for (long k=0; k<m_numRows; k++) if (m_rowIsSelected[0].at(k) & 1) {
-
-      for (j=0; j<vecSize; ) {
-        if (m_quantities[j].m_type == Quantity::NUM) {
-          r=m_numericals[m_quantities[j].m_index].at(k);
-#ifdef WIN32
-          if (_isnan(r)) {
-#else
-          if (std::isnan(r)) {
-#endif
-            len=lengths[j];
-            if (len == 0) len=1;
-/*             file << std::setw(len+1) << std::setfill(' ');
-DOES NOT WORK*/
-            sortie << "%" << len << "s";
-            text=sortie.str();
-            sprintf(buffer, text.c_str(), "");
-            file.write(buffer, len);
-            sortie.str("");
+    partRows=TEXT_OUTPUT/rowBytes;
+    if (partRows < 1) partRows=1;
+    nbParts=(outRows+partRows-1)/partRows;
+    int nbThreads=m_textThreads;
+    if (nbThreads == 0) nbThreads=std::thread::hardware_concurrency();
+    if (nbThreads > nbParts) nbThreads=nbParts;
+
+    if (nbThreads <= 1) {
+      std::string output;
+      output.reserve(TEXT_OUTPUT+(bufSize+1)*vecSize);
+      for (part=0; part<nbParts; part++) {
+        output.clear();
+        formatRows(part*partRows, std::min((part+1)*partRows, outRows),
+                   output);
+        put(output);
+      }
+    }
+    else {
+      // parts are formatted by the workers (at most 2 parts ahead
+      // per thread), then written in order by this thread
+      std::vector<std::string> parts(nbParts);
+      std::vector<char> ready(nbParts, 0);
+      std::string error;
+      std::mutex  lock;
+      std::condition_variable formatted, written;
+      long next=0,     // next part to format
+           nbWritten=0,
+           ahead=2*nbThreads;
+      std::vector<std::thread> workers;
+      for (i=0; i<nbThreads; i++) workers.push_back(std::thread([&]() {
+        long p;
+        std::string output;
+        for (;;) {
+          {
+            std::unique_lock<std::mutex> guard(lock);
+            written.wait(guard, [&]() {
+              return (next >= nbParts) || (next < nbWritten+ahead); });
+            if (next >= nbParts) return;
+            p=next++;
           }
-          else if (lengths[j] > 0) {
-            sprintf(buffer, formats[j].c_str(), r);
-            file.write(buffer, lengths[j]);
+          output.clear();
+          output.reserve(TEXT_OUTPUT+(bufSize+1)*vecSize);
+          try {
+            formatRows(p*partRows, std::min((p+1)*partRows, outRows), output);
           }
-          else file << r;
-        }
-        else if ((m_quantities[j].m_type == Quantity::STRING) ||
-                 (m_quantities[j].m_type == Quantity::LOGICALS)) {
-          text=m_strings[m_quantities[j].m_index].at(k);
-          if (lengths[j] > 0) {
-            sprintf(buffer, formats[j].c_str(), text.c_str());
-            file.write(buffer, lengths[j]);
+          catch (const std::exception &prob) {
+            std::lock_guard<std::mutex> guard(lock);
+            error=prob.what();
+            if (error.empty()) error="unknown";
           }
-          else file << text;
+          std::lock_guard<std::mutex> guard(lock);
+          parts[p].swap(output);
+          ready[p]=1;
+          formatted.notify_one();
         }
-        if (++j == vecSize) file << std::endl; else file << sep;
+      }));
+      for (part=0; part<nbParts; part++) {
+        std::string output;
+        std::unique_lock<std::mutex> guard(lock);
+        formatted.wait(guard, [&]() { return ready[part] != 0; });
+        if (!error.empty()) break;
+        output.swap(parts[part]);
+        nbWritten=part+1;
+        written.notify_all();
+        guard.unlock();
+        put(output);
       }
-      totData++;
-      if (totData == m_numSelRows) break;
-
-    } // loop on rows and quantities, selected branch
+      {
+        // on error, no more part is formatted
+        std::lock_guard<std::mutex> guard(lock);
+        next=nbParts;
+        written.notify_all();
+      }
+      for (i=0; i<nbThreads; i++) workers[i].join();
+      if (!error.empty()) throw std::runtime_error(error);
+    }
 
     if (saveAll) tot+=m_numRows; else tot+=m_numSelRows;
-    if (buffer != NULL) free(buffer);
   }
   catch (const std::exception &prob) {
     text=std::string("EXCEPTION writing rows in file: ")+prob.what();
     printErr(origin, text);
     throw;
   }
-  file << std::endl;
+  text="\n";
+  put(text);
   tot++;
+  if ( !packer.close() ) {
+    text=": FILENAME \""+fileName+"\" cannot be compressed";
+    printErr(origin, text);
+    return BAD_FILENAME;
+  }
   file.close();
   sortie << "output text file is closed ( " << tot << " lines written)";
   printLog(0, sortie.str());
@@ -1056,9 +2485,19 @@ DOES NOT WORK*/
 // save whole catalog from memory to a text file
 int Catalog::saveText(const std::string &fileName, bool clobber) {
 
+  return saveText(fileName, std::vector<std::string>(), clobber);
+}
+/**********************************************************************/
+// save some quantities of whole catalog from memory to a text file
+int Catalog::saveText(const std::string &fileName,
+                      const std::vector<std::string> &names, bool clobber) {
+
   const std::string origin="saveText";
+  std::vector<int> cols;
   int err;
-  err=createText(fileName, clobber, origin);
+  err=exportColumns(origin, names, &cols);
+  if (err < IS_VOID) return err;
+  err=createText(fileName, clobber, origin, cols);
   if (err < IS_VOID) return err;
 
   return IS_OK;
@@ -1067,9 +2506,20 @@ int Catalog::saveText(const std::string &fileName, bool clobber) {
 // save selected rows of catalog from memory to a text file
 int Catalog::saveSelectedText(const std::string &fileName, bool clobber) {
 
+  return saveSelectedText(fileName, std::vector<std::string>(), clobber);
+}
+/**********************************************************************/
+// save some quantities of selected rows from memory to a text file
+int Catalog::saveSelectedText(const std::string &fileName,
+                              const std::vector<std::string> &names,
+                              bool clobber) {
+
   const std::string origin="saveSelectedText";
+  std::vector<int> cols;
   int err;
-  err=createText(fileName, clobber, origin);
+  err=exportColumns(origin, names, &cols);
+  if (err < IS_VOID) return err;
+  err=createText(fileName, clobber, origin, cols);
   if (err < IS_VOID) return err;
 
   return IS_OK;
@@ -0,0 +1,805 @@
+/**
+ * @file   catalog_ioVOT.cxx
+ * @brief  Export/import of the catalog as VOTable (BINARY2 serialization).
+ *
+ * Written file: one RESOURCE (catalog name and reference) with one TABLE
+ * (table name and reference); each quantity gives a FIELD with its name,
+ * unit, ucd and comment (DESCRIPTION): numerical as double, VECTOR as
+ * fixed size double array, strings as variable char array. Rows are
+ * encoded in base64 by blocks while written (no document in memory).
+ *
+ * Read file: first TABLE with BINARY2 or BINARY stream (base64 inline),
+ * the header is scanned without building a tree, then rows are decoded
+ * by blocks directly into the catalog columns.
+ *
+ * $Header $
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>   //for int64_t
+#include "catalogAccess/catalog.h"
+
+namespace catalogAccess {
+
+/**********************************************************************/
+// binary rows encoded by blocks of whole base64 lines (57 bytes each)
+static const size_t VOT_LINE =57,
+                    VOT_BLOCK=VOT_LINE << 14;
+// maximal size of the header (before STREAM) searched in a file
+static const size_t VOT_HEAD =1 << 26;
+// maximal number of elements of a fixed size FIELD
+static const long VOT_COUNT=1 << 24;
+
+static const char B64_CHARS[]=
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// append to output the base64 lines of nb bytes (last line padded)
+static void encodeBase64(const unsigned char *in, const size_t nb,
+                         std::string &output) {
+
+  size_t i, line=0;
+  uint32_t v;
+  for (i=0; i+2<nb; i+=3) {
+    v=(in[i] << 16) | (in[i+1] << 8) | in[i+2];
+    output+=B64_CHARS[v >> 18];
+    output+=B64_CHARS[(v >> 12) & 63];
+    output+=B64_CHARS[(v >> 6) & 63];
+    output+=B64_CHARS[v & 63];
+    if (++line == VOT_LINE/3) { output+='\n'; line=0; }
+  }
+  if (i < nb) {
+    v=in[i] << 16;
+    if (i+1 < nb) v|=in[i+1] << 8;
+    output+=B64_CHARS[v >> 18];
+    output+=B64_CHARS[(v >> 12) & 63];
+    output+= (i+1 < nb) ? B64_CHARS[(v >> 6) & 63] : '=';
+    output+='=';
+    line++;
+  }
+  if (line) output+='\n';
+}
+
+// XML text or attribute value
+static std::string xmlEscape(const std::string &text) {
+
+  std::string out;
+  out.reserve(text.size());
+  for (size_t i=0; i<text.size(); i++) switch (text[i]) {
+    case '&': out+="&amp;";  break;
+    case '<': out+="&lt;";   break;
+    case '>': out+="&gt;";   break;
+    case '"': out+="&quot;"; break;
+    default:  out+=text[i];
+  }
+  return out;
+}
+
+// big endian values of the binary serialization
+static inline void putBig(unsigned char *out, uint64_t value, const int size) {
+
+  for (int k=size-1; k>=0; k--, value>>=8) out[k]=value & 0xFF;
+}
+static inline uint64_t getBig(const unsigned char *in, const int size) {
+
+  uint64_t value=0;
+  for (int k=0; k<size; k++) value=(value << 8) | in[k];
+  return value;
+}
+
+/**********************************************************************/
+// one XML tag of the header, namespace prefix removed
+struct XmlTag {
+  std::string name;
+  std::vector<std::pair<std::string, std::string> > attrs;
+  bool closing, empty;
+  std::string attr(const char *key) const {
+    for (size_t i=0; i<attrs.size(); i++)
+      if (attrs[i].first == key) return attrs[i].second;
+    return "";
+  }
+};
+
+// entities replaced, leading and trailing blanks removed
+static std::string xmlText(const std::string &raw) {
+
+  std::string out;
+  std::string::size_type i, end;
+  for (i=0; i<raw.size(); i++) {
+    if (raw[i] != '&') { out+=raw[i]; continue; }
+    end=raw.find(';', i);
+    if (end == std::string::npos) { out+=raw[i]; continue; }
+    const std::string ent=raw.substr(i+1, end-i-1);
+    if (ent == "amp") out+='&';
+    else if (ent == "lt") out+='<';
+    else if (ent == "gt") out+='>';
+    else if (ent == "quot") out+='"';
+    else if (ent == "apos") out+='\'';
+    else if ((ent.size() > 1) && (ent[0] == '#')) {
+      unsigned long code= (ent[1] == 'x') ? strtoul(ent.c_str()+2, NULL, 16)
+                                          : strtoul(ent.c_str()+1, NULL, 10);
+      out+= (code < 128) ? (char)code : '?';
+    }
+    else { out+=raw[i]; continue; }
+    i=end;
+  }
+  const char *blanks=" \t\r\n";
+  i=out.find_first_not_of(blanks);
+  if (i == std::string::npos) return "";
+  return out.substr(i, out.find_last_not_of(blanks)-i+1);
+}
+
+// next tag from pos, text before it (CDATA kept) in text;
+// comments, processing instructions and DOCTYPE are skipped
+static bool nextTag(const std::string &xml, std::string::size_type *pos,
+                    XmlTag *tag, std::string *text) {
+
+  std::string::size_type i=*pos, end;
+  text->clear();
+  while (1) {
+    end=xml.find('<', i);
+    if (end == std::string::npos) return false;
+    text->append(xml, i, end-i);
+    if (xml.compare(end, 4, "<!--") == 0) {
+      i=xml.find("-->", end);
+      if (i == std::string::npos) return false;
+      i+=3;
+    }
+    else if (xml.compare(end, 9, "<![CDATA[") == 0) {
+      i=xml.find("]]>", end);
+      if (i == std::string::npos) return false;
+      text->append(xml, end+9, i-end-9);
+      i+=3;
+    }
+    else if ((xml.compare(end, 2, "<?") == 0)
+             || (xml.compare(end, 2, "<!") == 0)) {
+      i=xml.find('>', end);
+      if (i == std::string::npos) return false;
+      i++;
+    }
+    else break;
+  }
+  i=end+1;
+  tag->closing=(i < xml.size()) && (xml[i] == '/');
+  if (tag->closing) i++;
+  end=xml.find_first_of(" \t\r\n/>", i);
+  if (end == std::string::npos) return false;
+  tag->name=xml.substr(i, end-i);
+  std::string::size_type colon=tag->name.find(':');
+  if (colon != std::string::npos) tag->name.erase(0, colon+1);
+  tag->attrs.clear();
+  tag->empty=false;
+  i=end;
+  while (1) {
+    i=xml.find_first_not_of(" \t\r\n", i);
+    if (i == std::string::npos) return false;
+    if (xml[i] == '>') { i++; break; }
+    if (xml.compare(i, 2, "/>") == 0) { tag->empty=true; i+=2; break; }
+    end=xml.find('=', i);
+    if (end == std::string::npos) return false;
+    std::string key=xml.substr(i, end-i);
+    key.erase(key.find_last_not_of(" \t\r\n")+1);
+    i=xml.find_first_of("\"'", end);
+    if (i == std::string::npos) return false;
+    end=xml.find(xml[i], i+1);
+    if (end == std::string::npos) return false;
+    tag->attrs.push_back(std::make_pair(key,
+                                        xmlText(xml.substr(i+1, end-i-1))));
+    i=end+1;
+  }
+  *pos=i;
+  return true;
+}
+
+// char after the first opening tag name (any namespace prefix),
+// NULL if not found or not complete
+static const char *tagEnd(const char *begin, const char *end,
+                          const char *name) {
+
+  const size_t size=strlen(name);
+  const char *p=begin, *q, *start;
+  while ((p=(const char *)memchr(p, '<', end-p)) != NULL) {
+    start=++p;
+    for (q=p; (q < end) && (!strchr(" \t\r\n/>", *q)); q++)
+      if (*q == ':') start=q+1;
+    if ((q-start == (long)size) && (memcmp(start, name, size) == 0)) {
+      q=(const char *)memchr(q, '>', end-q);
+      return (q) ? q+1 : NULL;
+    }
+  }
+  return NULL;
+}
+
+/**********************************************************************/
+// FIELD of the read TABLE and how its values are stored
+struct VOTField {
+  enum { BOOL, BIT, UBYTE, SHORT, INT, LONG, CHAR, UCHAR, FLOAT, DOUBLE,
+         CFLOAT, CDOUBLE, UNKNOWN };
+  std::string name, unit, ucd, comment;
+  int    kind, size;    // element type and bytes per element
+  long   count;         // number of elements if fixed size
+  bool   variable;      // elements count precedes the values
+  bool   hasNull;       // VALUES null of integers
+  double nullValue;
+  int    quantity;      // index in m_quantities
+};
+
+// element type and size from datatype, count from arraysize
+static bool fieldType(const std::string &datatype,
+                      const std::string &arraysize, VOTField *field) {
+
+  static const char *names[]={"boolean", "bit", "unsignedByte", "short",
+    "int", "long", "char", "unicodeChar", "float", "double", "floatComplex",
+    "doubleComplex"};
+  static const int sizes[]={1, 1, 1, 2, 4, 8, 1, 2, 4, 8, 8, 16};
+  int k;
+  field->kind=VOTField::UNKNOWN;
+  for (k=0; k<VOTField::UNKNOWN; k++) if (datatype == names[k]) {
+    field->kind=k;
+    field->size=sizes[k];
+  }
+  if (field->kind == VOTField::UNKNOWN) return false;
+  // dimensions "2x3x*": only the last one can be variable
+  field->count=1;
+  field->variable=false;
+  std::string::size_type i=0, end;
+  while (i < arraysize.size()) {
+    end=arraysize.find('x', i);
+    if (end == std::string::npos) end=arraysize.size();
+    const std::string dim=arraysize.substr(i, end-i);
+    if ((!dim.empty()) && (dim[dim.size()-1] == '*')) {
+      if (end != arraysize.size()) return false;
+      field->variable=true;
+    }
+    else {
+      if ((dim.empty())
+          || (dim.find_first_not_of("0123456789") != std::string::npos))
+        return false;
+      field->count*=atol(dim.c_str());
+      if ((dim.size() > 9) || (field->count > VOT_COUNT)) return false;
+    }
+    i=end+1;
+  }
+  return true;
+}
+
+/**********************************************************************/
+// save catalog rows (all or selected) to a VOTable file (private method)
+int Catalog::createVOTable(const std::string &fileName, bool clobber,
+                           const std::string origin, const bool selected) {
+
+  std::string text;
+  std::vector<int> cols;
+  int  err=exportColumns(origin, std::vector<std::string>(), &cols);
+  if (err < IS_VOID) return err;
+  if (fileName.empty()) {
+    printErr(origin, ": FILENAME is EMPTY");
+    return BAD_FILENAME;
+  }
+  if (!clobber) {
+    std::ifstream test(fileName.c_str());
+    if ( test.is_open() ) {
+      text=": FILENAME \""+fileName+"\" exist (clobber=no)";
+      printErr(origin, text);
+      return BAD_FILENAME;
+    }
+  }
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::trunc
+                                       | std::ios::binary);
+  if ( !file.is_open() ) {
+    text=": FILENAME \""+fileName+"\" cannot be written";
+    printErr(origin, text);
+    return BAD_FILENAME;
+  }
+  std::ostringstream sortie;
+  // only the selected rows are visited
+  std::vector<long> ids;
+  if (selected) selectedRows(&ids);
+  const long nrows= (selected) ? (long)ids.size() : m_numRows;
+  long l, tot=0;
+  int  i, j, c, max=cols.size(), nbV;
+  // VECTOR of unsupported format cannot be written
+  std::vector<int> fields;
+  for (c=0; c<max; c++) {
+    const Quantity &readQ=m_quantities[cols[c]];
+    if ((readQ.m_type == Quantity::VECTOR) && (readQ.m_vectorQs.empty())) {
+      sortie << "VECTOR format " << readQ.m_format << " not supported, "
+             << "quantity '" << readQ.m_name << "' not written";
+      printWarn(origin, sortie.str() );
+      sortie.str("");
+    }
+    else fields.push_back(cols[c]);
+  }
+  max=fields.size();
+
+  sortie << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+         << "<VOTABLE version=\"1.3\" "
+         << "xmlns=\"http://www.ivoa.net/xml/VOTable/v1.3\">\n"
+         << "<RESOURCE name=\"" << xmlEscape(m_catName) << "\">\n";
+  if ( !m_catRef.empty() )
+    sortie << "<DESCRIPTION>" << xmlEscape(m_catRef) << "</DESCRIPTION>\n";
+  sortie << "<TABLE name=\"" << xmlEscape(m_tableName) << "\" nrows=\""
+         << nrows << "\">\n";
+  if ( !m_tableRef.empty() )
+    sortie << "<DESCRIPTION>" << xmlEscape(m_tableRef) << "</DESCRIPTION>\n";
+  for (c=0; c<max; c++) {
+    const Quantity &readQ=m_quantities[fields[c]];
+    sortie << "<FIELD name=\"" << xmlEscape(readQ.m_name) << "\"";
+    if (readQ.m_type == Quantity::NUM) sortie << " datatype=\"double\"";
+    else if (readQ.m_type == Quantity::VECTOR)
+      sortie << " datatype=\"double\" arraysize=\""
+             << readQ.m_vectorQs.size() << "\"";
+    else sortie << " datatype=\"char\" arraysize=\"*\"";
+    if ( !readQ.m_unit.empty() )
+      sortie << " unit=\"" << xmlEscape(readQ.m_unit) << "\"";
+    if ( !readQ.m_ucd.empty() )
+      sortie << " ucd=\"" << xmlEscape(readQ.m_ucd) << "\"";
+    if (readQ.m_comment.empty()) sortie << "/>\n";
+    else sortie << ">\n  <DESCRIPTION>" << xmlEscape(readQ.m_comment)
+                << "</DESCRIPTION>\n</FIELD>\n";
+  }
+  sortie << "<DATA><BINARY2><STREAM encoding=\"base64\">\n";
+  text=sortie.str();
+  sortie.str("");
+  file.write(text.data(), text.size());
+
+  try {
+    // BINARY2 row: null flags (first field on highest bit), then values
+    const int nbFlags=(max+7)/8;
+    std::vector<unsigned char> rows;
+    rows.reserve(VOT_BLOCK+nbFlags+4096);
+    unsigned char *out;
+    uint64_t bits;
+    double   r;
+    size_t   size, done;
+    for (tot=0; tot<nrows; tot++) {
+      l= (selected) ? ids[tot] : tot;
+      size=rows.size();
+      rows.resize(size+nbFlags, 0);
+      for (c=0; c<max; c++) {
+        const Quantity &readQ=m_quantities[fields[c]];
+        j=readQ.m_index;
+        if (readQ.m_type == Quantity::NUM) {
+          r=m_numericals[j][l];
+          if (r != r) rows[size+c/8]|=0x80 >> (c%8); /* NaN is null */
+          memcpy(&bits, &r, 8);
+          rows.resize(rows.size()+8);
+          putBig(&rows[rows.size()-8], bits, 8);
+        }
+        else if (readQ.m_type == Quantity::VECTOR) {
+          nbV=readQ.m_vectorQs.size();
+          rows.resize(rows.size()+8*nbV);
+          out=&rows[rows.size()-8*nbV];
+          for (i=0; i<nbV; i++) {
+            memcpy(&bits, &m_vectors[j][l*nbV+i], 8);
+            putBig(out+8*i, bits, 8);
+          }
+        }
+        else {
+          const std::string &word=m_strings[j][l];
+          rows.resize(rows.size()+4);
+          putBig(&rows[rows.size()-4], word.size(), 4);
+          rows.insert(rows.end(), word.begin(), word.end());
+        }
+      }
+      if (rows.size() < VOT_BLOCK) continue;
+      // whole lines encoded, remaining bytes kept for next rows
+      done=rows.size()-rows.size()%VOT_LINE;
+      text.clear();
+      encodeBase64(&rows[0], done, text);
+      file.write(text.data(), text.size());
+      rows.erase(rows.begin(), rows.begin()+done);
+    }
+    text.clear();
+    if ( !rows.empty() ) encodeBase64(&rows[0], rows.size(), text);
+    text+="</STREAM></BINARY2></DATA>\n</TABLE>\n</RESOURCE>\n</VOTABLE>\n";
+    file.write(text.data(), text.size());
+  }
+  catch (const std::exception &prob) {
+    text=std::string("EXCEPTION writing VOTable rows: ")+prob.what();
+    printErr(origin, text);
+    throw;
+  }
+  file.close();
+  if ( file.fail() ) {
+    text=": FILENAME \""+fileName+"\" cannot be written";
+    printErr(origin, text);
+    return BAD_FILENAME;
+  }
+  sortie << "output VOTable is closed ( " << tot << " rows written)";
+  printLog(0, sortie.str());
+  return IS_OK;
+}
+/**********************************************************************/
+// save whole catalog from memory to a VOTable file
+int Catalog::saveVOTable(const std::string &fileName, bool clobber) {
+
+  return createVOTable(fileName, clobber, "saveVOTable", false);
+}
+/**********************************************************************/
+// save selected rows of catalog from memory to a VOTable file
+int Catalog::saveSelectedVOTable(const std::string &fileName, bool clobber) {
+
+  return createVOTable(fileName, clobber, "saveSelectedVOTable", true);
+}
+/**********************************************************************/
+// true if the file (maybe compressed) starts as an XML document
+bool Catalog::votableFile(const std::string &fileName) {
+
+  TextView view(fileName);
+  const char *begin=NULL, *end=NULL;
+  if ((!view.isOpen()) || (!view.nextLines(&begin, &end))) return false;
+  // UTF-8 byte order mark
+  if ((end-begin >= 3) && (memcmp(begin, "\xEF\xBB\xBF", 3) == 0)) begin+=3;
+  while ((begin < end) && (isspace((unsigned char)*begin))) begin++;
+  return ((end-begin >= 5) && (memcmp(begin, "<?xml", 5) == 0))
+      || ((end-begin >= 8) && (memcmp(begin, "<VOTABLE", 8) == 0));
+}
+/**********************************************************************/
+// read the first TABLE of a VOTable: description from the FIELD elements,
+// rows from the base64 BINARY2 (or BINARY) stream (private method)
+int Catalog::loadVOTable(const std::string &fileName, const bool getDescr,
+                         const std::string origin, long *maxRows) {
+
+  std::ostringstream sortie;
+  std::string text, head;
+  TextView view(fileName);
+  if ( !view.isOpen() ) {
+    text=": FILENAME \""+fileName+"\" cannot be opened";
+    printErr(origin, text);
+    return BAD_FILENAME;
+  }
+  // header up to the start of stream, data after it (in file or copied)
+  const char *begin=NULL, *end=NULL, *data=NULL;
+  std::string pending;
+  const char *close;
+  while ((head.size() < VOT_HEAD) && (view.nextLines(&begin, &end))) {
+    if ( head.empty() ) {
+      close=tagEnd(begin, end, "STREAM");
+      if (close) {
+        head.assign(begin, close);
+        data=close;
+        break;
+      }
+      head.assign(begin, end);
+    }
+    else {
+      head.append(begin, end);
+      close=tagEnd(head.data(), head.data()+head.size(), "STREAM");
+      if (close) {
+        const std::string::size_type pos=close-head.data();
+        pending=head.substr(pos);
+        head.erase(pos);
+        break;
+      }
+    }
+    if ((tagEnd(head.data(), head.data()+head.size(), "TABLEDATA"))
+        || (tagEnd(head.data(), head.data()+head.size(), "FITS"))) break;
+  }
+  if (view.failed()) {
+    text=": FILENAME \""+fileName+"\" cannot be uncompressed";
+    printErr(origin, text);
+    return BAD_FILETYPE;
+  }
+
+  // description from the header tags (first TABLE only)
+  XmlTag tag;
+  std::vector<VOTField> fields;
+  VOTField field;
+  std::string::size_type at=0;
+  bool inResource=false, inTable=false, inField=false, binary2=false,
+       hasStream=false, tableDone=false;
+  long nrows=-1;
+  m_catName="";   m_catRef="";
+  m_tableName=""; m_tableRef="";
+  m_URL="";
+  while ((!tableDone) && (nextTag(head, &at, &tag, &text))) {
+    if (tag.closing) {
+      if (tag.name == "DESCRIPTION") {
+        if (inField) field.comment=xmlText(text);
+        else if ((inTable) && (m_tableRef.empty())) m_tableRef=xmlText(text);
+        else if ((inResource) && (!inTable) && (m_catRef.empty()))
+          m_catRef=xmlText(text);
+      }
+      else if ((tag.name == "FIELD") && (inField)) {
+        fields.push_back(field);
+        inField=false;
+      }
+      else if (tag.name == "TABLE") tableDone=true;
+      continue;
+    }
+    if (tag.name == "RESOURCE") {
+      if ((!inResource) && (!inTable)) m_catName=tag.attr("name");
+      inResource=true;
+    }
+    else if (tag.name == "TABLE") {
+      inTable=true;
+      m_tableName=tag.attr("name");
+      text=tag.attr("nrows");
+      if ( !text.empty() ) nrows=atol(text.c_str());
+    }
+    else if ((tag.name == "FIELD") && (inTable)) {
+      field=VOTField();
+      field.name=tag.attr("name");
+      field.unit=tag.attr("unit");
+      field.ucd =tag.attr("ucd");
+      field.hasNull=false;
+      field.nullValue=0.;
+      if ( !fieldType(tag.attr("datatype"), tag.attr("arraysize"), &field) ) {
+        field.kind=VOTField::UNKNOWN;
+        sortie << ": VOTable FIELD '" << field.name << "' has unknown "
+               << "datatype or arraysize";
+        printErr(origin, sortie.str() );
+        return BAD_FILETYPE;
+      }
+      if (tag.empty) fields.push_back(field);
+      else inField=true;
+    }
+    else if ((tag.name == "VALUES") && (inField)) {
+      text=tag.attr("null");
+      if ( !text.empty() ) {
+        field.hasNull=true;
+        field.nullValue=atof(text.c_str());
+      }
+    }
+    else if ((tag.name == "BINARY2") && (inTable)) binary2=true;
+    else if ((tag.name == "STREAM") && (inTable)) {
+      if ((tag.attr("encoding") != "base64") || (!tag.attr("href").empty())) {
+        printErr(origin, ": VOTable STREAM must be base64 inline data");
+        return BAD_FILETYPE;
+      }
+      hasStream=true;
+      break;
+    }
+    else if (((tag.name == "TABLEDATA") || (tag.name == "FITS"))
+             && (inTable)) {
+      text=": VOTable "+tag.name+" serialization not supported "
+           +"(only BINARY2 or BINARY)";
+      printErr(origin, text);
+      return BAD_FILETYPE;
+    }
+  }
+  if ((!inTable) || (fields.empty())) {
+    printErr(origin, ": VOTable without TABLE or FIELD");
+    return BAD_FILETYPE;
+  }
+  if ((!getDescr) && (!hasStream)) {
+    printErr(origin, ": VOTable data without BINARY2 or BINARY stream");
+    return BAD_FILETYPE;
+  }
+  sortie << "VOTable TABLE name = " << m_tableName;
+  printLog(1, sortie.str());
+  sortie.str("");
+
+  // quantities as for a FITS BINTABLE
+  int  i, j, k, max=fields.size(), nbQuantNum=0, nbQuantVec=0;
+  for (i=0; i<max; i++) {
+    VOTField &f=fields[i];
+    Quantity readQ;
+    readQ.m_name=f.name;
+    readQ.m_unit=f.unit;
+    readQ.m_ucd =f.ucd;
+    readQ.m_comment=f.comment;
+    sortie << f.count;
+    if ((f.kind == VOTField::CHAR) || (f.kind == VOTField::UCHAR)
+        || (f.kind == VOTField::BOOL)) {
+      readQ.m_type=Quantity::STRING;
+      readQ.m_format=sortie.str()+"A";   /* width updated after data */
+    }
+    else if ((f.kind == VOTField::BIT) || (f.kind == VOTField::CFLOAT)
+             || (f.kind == VOTField::CDOUBLE) || (f.variable)) {
+      readQ.m_type=Quantity::VECTOR;
+      if (f.kind == VOTField::BIT) readQ.m_format=sortie.str()+"X";
+      else if (f.kind == VOTField::CFLOAT) readQ.m_format=sortie.str()+"C";
+      else if (f.kind == VOTField::CDOUBLE) readQ.m_format=sortie.str()+"M";
+      else readQ.m_format="PD";
+      sortie.str("");
+      sortie << "VECTOR format " << readQ.m_format
+             << " not supported, unusable column#" << i+1;
+      printWarn(origin, sortie.str() );
+    }
+    else if (f.count == 1) {
+      readQ.m_type=Quantity::NUM;
+      readQ.m_format="1D";
+    }
+    else {
+      readQ.m_type=Quantity::VECTOR;
+      readQ.m_format=sortie.str()+"D";
+      for (long n=1; n <= f.count; n++) {
+        sortie.str("");
+        sortie << readQ.m_name << "[" << n << "]";
+        readQ.m_vectorQs.push_back(sortie.str());
+      }
+    }
+    sortie.str("");
+    if (readQ.m_type == Quantity::NUM) readQ.m_index=nbQuantNum++;
+    else if (readQ.m_type == Quantity::VECTOR) readQ.m_index=nbQuantVec++;
+    else readQ.m_index=m_quantities.size()-nbQuantNum-nbQuantVec;
+    f.quantity=m_quantities.size();
+    m_quantities.push_back(readQ);
+  }
+  m_numRows=0;
+  m_numOriRows= (nrows >= 0) ? nrows : 0;
+  if (getDescr) return IS_OK;
+
+  // rows decoded from base64 by blocks, then parsed from binary
+  long cap=(nrows > 0) ? nrows : 1024,
+       limit=*maxRows;
+  if ((limit > 0) && (cap > limit)) cap=limit;
+  create_tables(nbQuantNum, cap);
+  const int nbFlags= (binary2) ? (max+7)/8 : 0;
+  std::vector<unsigned char> bin;
+  std::vector<size_t> widths(max, 0);
+  size_t done=0;
+  long   textBytes=0;
+  bool   ended=false, truncated=false;
+  signed char decode[256];
+  memset(decode, -1, sizeof(decode));
+  for (i=0; i<64; i++) decode[(unsigned char)B64_CHARS[i]]=i;
+  uint32_t quad=0;
+  int      nbQuad=0;
+
+  // one row from p (false if incomplete), stored at m_numRows
+  auto parseRow=[&](const unsigned char *p, const unsigned char *e,
+                    const unsigned char **next) {
+    if (e-p < nbFlags) return false;
+    const unsigned char *flags=p;
+    p+=nbFlags;
+    long   n, m;
+    double r;
+    uint64_t bits;
+    for (int c=0; c<max; c++) {
+      const VOTField &f=fields[c];
+      const Quantity &readQ=m_quantities[f.quantity];
+      bool isNull= (nbFlags) && (flags[c/8] & (0x80 >> (c%8)));
+      n=f.count;
+      if (f.variable) {
+        if (e-p < 4) return false;
+        n=getBig(p, 4);
+        p+=4;
+      }
+      long bytes= (f.kind == VOTField::BIT) ? (n+7)/8 : n*f.size;
+      if (e-p < bytes) return false;
+      j=readQ.m_index;
+      if (readQ.m_type == Quantity::STRING) {
+        std::string &word=m_strings[j][m_numRows];
+        word.clear();
+        if (!isNull) for (m=0; m<n; m++) {
+          if (f.kind == VOTField::CHAR) {
+            if (p[m] == 0) break; /* end of C string */
+            word+=(char)p[m];
+          }
+          else if (f.kind == VOTField::UCHAR) {
+            bits=getBig(p+2*m, 2);
+            if (bits == 0) break;
+            word+= (bits < 128) ? (char)bits : '?';
+          }
+          else word+= (p[m] == 'T') || (p[m] == 't') || (p[m] == '1') ? 'T'
+                    : (p[m] == 'F') || (p[m] == 'f') || (p[m] == '0') ? 'F'
+                    : ' ';
+        }
+        if (word.size() > widths[c]) widths[c]=word.size();
+      }
+      else if ((readQ.m_type == Quantity::NUM)
+               || (!readQ.m_vectorQs.empty())) {
+        double *out= (readQ.m_type == Quantity::NUM)
+                     ? &m_numericals[j][m_numRows]
+                     : &m_vectors[j][m_numRows*n];
+        for (m=0; m<n; m++) {
+          bits=getBig(p+m*f.size, f.size);
+          switch (f.kind) {
+          case VOTField::UBYTE:  r=(double)bits; break;
+          case VOTField::SHORT:  r=(double)(int16_t)bits; break;
+          case VOTField::INT:    r=(double)(int32_t)bits; break;
+          case VOTField::LONG:   r=(double)(int64_t)bits; break;
+          case VOTField::FLOAT: {
+            uint32_t b32=bits;
+            float    f32;
+            memcpy(&f32, &b32, 4);
+            r=f32;
+            break;
+          }
+          default: memcpy(&r, &bits, 8); break;
+          }
+          if ((isNull) || ((f.hasNull) && (r == f.nullValue))) r=MissNAN;
+          out[m]=r;
+        }
+      }
+      p+=bytes;
+    }
+    *next=p;
+    return true;
+  };
+
+  try {
+    const unsigned char *p, *e, *next;
+    // data copied from header first (compressed file), then from view
+    const char *c= (data) ? data : pending.data(),
+               *last= (data) ? end : pending.data()+pending.size();
+    if ((!data) && (pending.empty()) && (!view.nextLines(&c, &last)))
+      c=last=NULL;
+    while ((c) && (!ended)) {
+      // decode about VOT_BLOCK base64 characters
+      const char *from=c,
+                 *stop= (last-c > (long)VOT_BLOCK) ? c+VOT_BLOCK : last;
+      for (; c<stop; c++) {
+        const signed char v=decode[(unsigned char)*c];
+        if (v < 0) {
+          if (*c == '<') { ended=true; break; }
+          continue; /* blanks, and '=' padding */
+        }
+        quad=(quad << 6) | v;
+        if (++nbQuad < 4) continue;
+        bin.push_back(quad >> 16);
+        bin.push_back((quad >> 8) & 0xFF);
+        bin.push_back(quad & 0xFF);
+        quad=0;
+        nbQuad=0;
+      }
+      textBytes+=c-from;
+      if (ended) {
+        // last group of 2 or 3 characters (padded)
+        if (nbQuad == 2) bin.push_back((quad >> 4) & 0xFF);
+        else if (nbQuad == 3) {
+          bin.push_back((quad >> 10) & 0xFF);
+          bin.push_back((quad >> 2) & 0xFF);
+        }
+      }
+      // complete rows are stored
+      p=bin.empty() ? NULL : &bin[0];
+      e=p+bin.size();
+      done=0;
+      while ((p) && (p+done < e) && ((limit <= 0) || (m_numRows < limit))) {
+        if (m_numRows == cap) {
+          cap*=2;
+          if ((limit > 0) && (cap > limit)) cap=limit;
+          add_rows(cap);
+        }
+        if ( !parseRow(p+done, e, &next) ) break;
+        done=next-p;
+        m_numRows++;
+        if (((m_numRows & 0xFFF) == 0) && (!importGoesOn(m_numRows, textBytes)))
+          return IMPORT_CANCEL;
+      }
+      if ((limit > 0) && (m_numRows >= limit)) break;
+      bin.erase(bin.begin(), bin.begin()+done);
+      if (ended) break;
+      if (c < last) continue;
+      c=NULL;
+      if ( view.nextLines(&c, &last) ) continue;
+      c=NULL;
+    }
+    // stream must end after a whole row, unless maxRows are read
+    if ((limit <= 0) || (m_numRows < limit))
+      truncated=(!ended) || (!bin.empty());
+  }
+  catch (const std::exception &prob) {
+    text=std::string("EXCEPTION reading VOTable rows: ")+prob.what();
+    printErr(origin, text);
+    throw;
+  }
+  if ((truncated) || (view.failed())) {
+    sortie << ": VOTable STREAM is truncated or corrupted after row#"
+           << m_numRows;
+    printErr(origin, sortie.str() );
+    return BAD_ROW;
+  }
+  if (nrows < 0) m_numOriRows=m_numRows;
+  // string widths as in FITS formats (used by text export)
+  for (i=0; i<max; i++) {
+    Quantity &readQ=m_quantities[fields[i].quantity];
+    if (readQ.m_type != Quantity::STRING) continue;
+    k=widths[i];
+    if (k < fields[i].count) k=fields[i].count;
+    if (k < 1) k=1;
+    sortie.str("");
+    sortie << k << "A";
+    readQ.m_format=sortie.str();
+  }
+  *maxRows=cap;
+  if (!importGoesOn(m_numRows, textBytes)) return IMPORT_CANCEL;
+  return IS_OK;
+}
+
+} // namespace catalogAccess
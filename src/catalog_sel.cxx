@@ -61,6 +61,13 @@ int Catalog::selectAllQuantities(const bool toBeLoaded) {
 // check if given row is inside the elliptical region (private method)
 bool Catalog::checkRegion(const long row, const int nRA, const int nDEC) {
 
+  return inRegion(m_numericals[nRA].at(row), m_numericals[nDEC].at(row));
+}
+/**********************************************************************/
+// check if given position is inside the elliptical region
+// (private method, also used while loading text rows)
+bool Catalog::inRegion(const double myRA, const double myDEC) const {
+
   /* for the moment, only circle
     if angle phi=RA and t=PI/2 - DEC then:
     OM postion is x= (sin t <=> cos DEC) * cos phi
@@ -69,8 +76,6 @@ bool Catalog::checkRegion(const long row, const int nRA, const int nDEC) {
    and the circular region around OA is defined by
    its scalar product with OM > cos desired_angle
   */
-  double myRA=m_numericals[nRA].at(row);
-  double myDEC=m_numericals[nDEC].at(row);
 #ifdef WIN32
    if (_isnan(myRA))  return !(m_quantities[m_indexRA].m_rejectNaN);
    if (_isnan(myDEC)) return !(m_quantities[m_indexDEC].m_rejectNaN);
@@ -95,7 +100,7 @@ bool Catalog::checkRegion(const long row, const int nRA, const int nDEC) {
 // check if value pass criteria for given quantity index (cut AND list)
 // private method called by useOnlyN, excludeN
 bool Catalog::checkNUM(const double r, const int index, const bool miss,
-                       const bool reject, const double precis) {
+                       const bool reject, const double precis) const {
 
   // since we test the NaN only once at the beginning
   // this methods MUST NOT be called if no criteria is applied
@@ -137,7 +142,7 @@ bool Catalog::checkNUM(const double r, const int index, const bool miss,
 // check if value pass criteria for given quantity index (cut OR list)
 // private method called by includeN
 bool Catalog::checkNUMor(const double r, const int index,
-                         const bool reject, const double precis) {
+                         const bool reject, const double precis) const {
 
   // since we test the NaN only once at the beginning
   // this methods MUST NOT be called if no criteria is applied
@@ -183,6 +188,42 @@ bool Catalog::checkNUMor(const double r, const int index,
 
 }
 
+/**********************************************************************/
+// set the bit of given VECTOR quantity index for all rows (private method)
+// true if each element is within its cuts (NaN only pass if not rejected)
+void Catalog::cutVEC(const int index) {
+
+  const Quantity &readQ=m_quantities[index];
+  const int nbV=readQ.m_vectorQs.size();
+  if (nbV == 0) return;
+  int  e, k, pass;
+  unsigned long test=bitPosition(index, &k);
+  // missing cut becomes infinite, element without any cut accepts NaN
+  std::vector<double> low(nbV), up(nbV);
+  std::vector<int>    nanOK(nbV);
+  for (e=0; e<nbV; e++) {
+    low[e]=readQ.m_lowerVecCuts.at(e);
+    up[e] =readQ.m_upperVecCuts.at(e);
+    nanOK[e]=(!readQ.m_rejectNaN) || ((low[e]>=NO_SEL_CUT)&&(up[e]>=NO_SEL_CUT));
+    if (low[e] >= NO_SEL_CUT) low[e]= -std::numeric_limits<double>::infinity();
+    if (up[e] >= NO_SEL_CUT)  up[e] =  std::numeric_limits<double>::infinity();
+  }
+  const double *r=&m_vectors[readQ.m_index].at(0),
+               *myLow=&low[0], *myUp=&up[0];
+  const int    *myNaN=&nanOK[0];
+  for (long i=0; i<m_numRows; i++, r+=nbV) {
+    // no branch on elements: loop can be vectorized by the compiler
+    pass=1;
+    for (e=0; e<nbV; e++)
+      pass&=((r[e] >= myLow[e]) & (r[e] <= myUp[e]))
+           | ((r[e] != r[e]) & myNaN[e]);
+    if (pass)
+      m_rowIsSelected[k].at(i)|= test;
+    else
+      m_rowIsSelected[k].at(i)&= (Max_Test-test);
+  }// loop on rows
+}
+
 /**********************************************************************/
 // compute the global bit selection at existing row,
 // suppose that m_rowIsSelected is correctly set (private method)
@@ -228,6 +269,22 @@ bool Catalog::rowSelect(const long row, const std::vector<bool> &quantSel) {
 
   return check;
 }
+/**********************************************************************/
+// indices of the selected rows (private method): the scan stops at the
+// last selected row, exports then only visit these rows
+void Catalog::selectedRows(std::vector<long> *rows) const {
+
+  rows->clear();
+  if ((m_numSelRows <= 0) || (m_rowIsSelected.empty())
+      || ((long)m_rowIsSelected[0].size() < m_numRows)) return;
+  rows->reserve(m_numSelRows);
+  // first bit indicates global selection
+  const unsigned long *sel=m_rowIsSelected[0].data();
+  for (long l=0; l<m_numRows; l++) if (sel[l] & 1ul) {
+    rows->push_back(l);
+    if ((long)rows->size() == m_numSelRows) break;
+  }
+}
 
 
 /**********************************************************************/
@@ -238,6 +295,8 @@ void Catalog::unsetCuts(const int index) {
   m_quantities.at(index).m_lowerCut=NO_SEL_CUT;
   m_quantities.at(index).m_upperCut=NO_SEL_CUT;
   m_quantities.at(index).m_listValN.clear();
+  m_quantities.at(index).m_lowerVecCuts.clear();
+  m_quantities.at(index).m_upperVecCuts.clear();
   /* if no data: exit */
   if (m_numRows == 0) return;
 
@@ -295,6 +354,8 @@ int Catalog::unsetCuts() {
     m_quantities.at(j).m_lowerCut=NO_SEL_CUT;
     m_quantities.at(j).m_upperCut=NO_SEL_CUT;
     m_quantities.at(j).m_listValN.clear();
+    m_quantities.at(j).m_lowerVecCuts.clear();
+    m_quantities.at(j).m_upperVecCuts.clear();
   }
   m_selection="";
   /* if no data: exit */
@@ -653,14 +714,97 @@ int Catalog::setUpperCut(const std::string name, double cutVal) {
   return IS_OK;
 }
 
+/**********************************************************************/
+// set and apply cuts on the elements of VECTOR quantity (private method)
+// cut values >= NO_SEL_CUT disable the cut on given element
+int Catalog::doCutVec(const std::string origin, const std::string name,
+                      const bool isLower, const std::vector<double> &cutValues) {
+
+  int quantSize=checkImport(origin, true);
+  if (quantSize < IS_VOID) return quantSize;
+
+  int index=checkQuant_name(origin, name);
+  if (index < 0) return index;
+  if (m_quantities.at(index).m_type != Quantity::VECTOR) {
+    std::string errText;
+    errText="given Quantity name ("+name+") is not of VECTOR type";
+    printWarn(origin, errText);
+    return BAD_QUANT_TYPE;
+  }
+  std::ostringstream sortie;
+  Quantity &readQ=m_quantities[index];
+  int e, nbV=readQ.m_vectorQs.size();
+  if ((nbV == 0) || ((int)cutValues.size() != nbV)) {
+    sortie << "need " << nbV << " cut values (one per VECTOR element)";
+    printWarn(origin, sortie.str());
+    return BAD_SEL_LIM;
+  }
+  if (readQ.m_lowerVecCuts.empty()) {
+    readQ.m_lowerVecCuts.assign(nbV, NO_SEL_CUT);
+    readQ.m_upperVecCuts.assign(nbV, NO_SEL_CUT);
+  }
+  std::vector<double> &myCuts=(isLower ? readQ.m_lowerVecCuts :
+                                         readQ.m_upperVecCuts);
+  // if cuts are the same: do nothing
+  bool check=true;
+  double cutVal;
+  for (e=0; e<nbV; e++) {
+    cutVal=cutValues[e];
+    if (cutVal >= NO_SEL_CUT) cutVal=NO_SEL_CUT;
+    if (cutVal != myCuts[e]) { myCuts[e]=cutVal; check=false; }
+  }
+  if (check) return IS_OK;
+
+  /* if no data: exit */
+  if (m_numRows == 0) return IS_OK;
+
+  std::vector<bool> isSelected;
+  if (!existCriteria(&isSelected)) {
+    if (m_numSelRows > 0) {
+      quantSize=m_rowIsSelected.size();
+      for (e=0; e<quantSize; e++) m_rowIsSelected[e].assign(m_numRows, 0);
+    }
+    m_numSelRows=0;
+    printLog(0, "All rows unselected");
+    return IS_OK;
+  }
+  if (isLower) sortie << "Setting lower cuts on ";
+  else sortie << "Setting upper cuts on ";
+  sortie << nbV << " elements (of " << name << ")";
+  printLog(1, sortie.str());
+
+  long i;
+  // true if given quantity is selected (at least one element cut)
+  if (isSelected.at(index+1)) cutVEC(index);
+  else {
+    int k;
+    unsigned long test=bitPosition(index, &k);
+    // required bit set to FALSE
+    for (i=0; i<m_numRows; i++) m_rowIsSelected[k].at(i)&= (Max_Test-test);
+  }
+  m_numSelRows=0;
+  for (i=0; i<m_numRows; i++) {
+    if (rowSelect(i, isSelected) == true) m_numSelRows++;
+  }
+  return IS_OK;
+}
 /**********************************************************************/
 // set and apply a cut on quantities in VECTOR type quantity "name"
 // such that all values >= cutValues[i] pass
- 
+int Catalog::setLowerVecCuts(const std::string name,
+                             const std::vector<double> &cutValues) {
+
+  return doCutVec("setLowerVecCuts", name, true, cutValues);
+}
 /**********************************************************************/
 // set and apply a cut on quantities in VECTOR type quantity "name"
 // such that all values <= cutValues[i] pass
- 
+int Catalog::setUpperVecCuts(const std::string name,
+                             const std::vector<double> &cutValues) {
+
+  return doCutVec("setUpperVecCuts", name, false, cutValues);
+}
+
 
 /**********************************************************************/
 // select rows depending on the given numerical list for existing index
@@ -831,9 +975,10 @@ int Catalog::setRejectNaN(const std::string name, const bool rejectNaN) {
   if (quantSize < IS_VOID) return quantSize;
   int index=checkQuant_name(origin, name);
   if (index < 0) return index;
-  if (m_quantities.at(index).m_type != Quantity::NUM) {  
+  if ((m_quantities.at(index).m_type != Quantity::NUM) &&
+      (m_quantities.at(index).m_type != Quantity::VECTOR)) {
     std::string errText;
-    errText="given Quantity name ("+name+") is not of NUM type";
+    errText="given Quantity name ("+name+") is not of NUM or VECTOR type";
     printWarn(origin, errText);
     return BAD_QUANT_TYPE;
   }
@@ -854,6 +999,13 @@ int Catalog::setRejectNaN(const std::string name, const bool rejectNaN) {
     else text=text+" accepted (on ";
     text=text+name+ ")";
     printLog(1, text);
+    if (m_quantities[index].m_type == Quantity::VECTOR) {
+      cutVEC(index);
+      m_numSelRows=0;
+      for (long i=0; i<m_numRows; i++)
+        if (rowSelect(i, isSelected) == true) m_numSelRows++;
+      return IS_OK;
+    }
     bool check,
          cutOR=m_quantities[index].m_cutORed,
          miss=m_quantities[index].m_excludeList;
@@ -1202,12 +1354,21 @@ int Catalog::eraseNonSelected() {
     int j;
     int sizeS=m_strings.size();
     int sizeN=m_numericals.size();
+    int sizeV=m_vectors.size();
     int vecSize=m_rowIsSelected.size();
     // to speed-up, will not change (avoid reading size in loop)
 
     std::vector<std::vector<double> > myNum;
     myNum.resize(sizeN);
     for (j=0; j<sizeN; j++) myNum[j].assign(m_numSelRows, 0.0);
+    std::vector<long> nbV(sizeV, 0); // VECTOR stride
+    std::vector<Quantity>::const_iterator itQ=m_quantities.begin();
+    for (; itQ != m_quantities.end(); ++itQ)
+      if (itQ->m_type == Quantity::VECTOR)
+        nbV.at(itQ->m_index)=itQ->m_vectorQs.size();
+    std::vector<std::vector<double> > myVec;
+    myVec.resize(sizeV);
+    for (j=0; j<sizeV; j++) myVec[j].assign(m_numSelRows*nbV[j], 0.0);
     std::vector<std::vector<std::string> > myStr;
     myStr.resize(sizeS);
     for (j=0; j<sizeS; j++) myStr[j].assign(m_numSelRows, "");
@@ -1218,6 +1379,10 @@ int Catalog::eraseNonSelected() {
       if (m_rowIsSelected[0].at(i) & 1) {
         for (j=0; j<sizeN; j++) myNum[j].at(tot)=m_numericals[j].at(i);
         for (j=0; j<sizeS; j++) myStr[j].at(tot)=m_strings[j].at(i);
+        for (j=0; j<sizeV; j++)
+          std::copy(m_vectors[j].begin()+i*nbV[j],
+                    m_vectors[j].begin()+(i+1)*nbV[j],
+                    myVec[j].begin()+tot*nbV[j]);
         for (j=0; j<vecSize; j++) myBits[j].at(tot)=m_rowIsSelected[j].at(i);
         if (++tot == m_numSelRows) break; // to speed up
       }
@@ -1234,6 +1399,8 @@ int Catalog::eraseNonSelected() {
       myStr[j].clear();
     }
     myStr.clear();
+    for (j=0; j<sizeV; j++) m_vectors[j].swap(myVec[j]);
+    myVec.clear();
     for (j=0; j<vecSize; j++)  {
       m_rowIsSelected[j].insert(m_rowIsSelected[j].begin(),
                                 myBits[j].begin(), myBits[j].end());
@@ -1318,12 +1485,21 @@ int Catalog::eraseSelected() {
     int j;
     int sizeS=m_strings.size();
     int sizeN=m_numericals.size();
+    int sizeV=m_vectors.size();
     int vecSize=m_rowIsSelected.size();
     // to speed-up, will not change (avoid reading size in loop)
 
     std::vector<std::vector<double> > myNum;
     myNum.resize(sizeN);
     for (j=0; j<sizeN; j++) myNum[j].assign(numRows, 0.0);
+    std::vector<long> nbV(sizeV, 0); // VECTOR stride
+    std::vector<Quantity>::const_iterator itQ=m_quantities.begin();
+    for (; itQ != m_quantities.end(); ++itQ)
+      if (itQ->m_type == Quantity::VECTOR)
+        nbV.at(itQ->m_index)=itQ->m_vectorQs.size();
+    std::vector<std::vector<double> > myVec;
+    myVec.resize(sizeV);
+    for (j=0; j<sizeV; j++) myVec[j].assign(numRows*nbV[j], 0.0);
     std::vector<std::vector<std::string> > myStr;
     myStr.resize(sizeS);
     for (j=0; j<sizeS; j++) myStr[j].assign(numRows, "");
@@ -1334,6 +1510,10 @@ int Catalog::eraseSelected() {
       if (!(m_rowIsSelected[0].at(i) & 1)) {
         for (j=0; j<sizeN; j++) myNum[j].at(tot)=m_numericals[j].at(i);
         for (j=0; j<sizeS; j++) myStr[j].at(tot)=m_strings[j].at(i);
+        for (j=0; j<sizeV; j++)
+          std::copy(m_vectors[j].begin()+i*nbV[j],
+                    m_vectors[j].begin()+(i+1)*nbV[j],
+                    myVec[j].begin()+tot*nbV[j]);
         for (j=0; j<vecSize; j++) myBits[j].at(tot)=m_rowIsSelected[j].at(i);
         if (++tot == numRows) break; // to speed up
       }
@@ -1350,6 +1530,8 @@ int Catalog::eraseSelected() {
       myStr[j].clear();
     }
     myStr.clear();
+    for (j=0; j<sizeV; j++) m_vectors[j].swap(myVec[j]);
+    myVec.clear();
     for (j=0; j<vecSize; j++)  {
       m_rowIsSelected[j].insert(m_rowIsSelected[j].begin(),
                                 myBits[j].begin(), myBits[j].end());
@@ -11,6 +11,7 @@
  */
 
 #include "catalogAccess/quantity.h"
+#include <mutex>
 
 namespace catalogAccess {
 
@@ -18,18 +19,23 @@ namespace catalogAccess {
 /*  GLOBAL FUNCTION for catalogAccess                                 */
 /**********************************************************************/
 int verbosity;
+// messages of files imported in parallel (importFiles) are not mixed
+static std::mutex s_printMutex;
 
 void printErr(const std::string origin, const std::string text) {
+  std::lock_guard<std::mutex> lock(s_printMutex);
   std::cerr << "ERROR catalogAccess (IN " << origin << ") "
             << text << std::endl;
 }
 void printWarn(const std::string origin, const std::string text) {
-  if (verbosity > 0)
+  if (verbosity <= 0) return;
+  std::lock_guard<std::mutex> lock(s_printMutex);
   std::cerr << "WARNING catalogAccess (IN " << origin << "): "
             << text << std::endl;
 }
 void printLog(const int level, const std::string text) {
-  if (verbosity+level >= 4)
+  if (verbosity+level < 4) return;
+  std::lock_guard<std::mutex> lock(s_printMutex);
   std::cout << "LOG_" << (int)level << " (catalogAccess): "
             << text << std::endl;
 }
@@ -77,6 +83,10 @@ Quantity::Quantity(const Quantity & q) {
     for (i=0; i<vecSize; i++) m_listValS.push_back(q.m_listValS.at(i));
     vecSize=q.m_listValN.size();
     for (i=0; i<vecSize; i++) m_listValN.push_back(q.m_listValN.at(i));
+    vecSize=q.m_lowerVecCuts.size();
+    for (i=0; i<vecSize; i++) m_lowerVecCuts.push_back(q.m_lowerVecCuts.at(i));
+    vecSize=q.m_upperVecCuts.size();
+    for (i=0; i<vecSize; i++) m_upperVecCuts.push_back(q.m_upperVecCuts.at(i));
   }
   catch (const std::exception &err) {
     errText=std::string("EXCEPTION on selection list: ")+err.what();
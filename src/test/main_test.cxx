@@ -8,9 +8,13 @@
 
 #include "st_facilities/Environment.h"
 #include "catalogAccess/catalog.h"
+#include "fitsio.h"
 #include <iomanip>
 #ifdef WIN32
 #include "facilities/AssertDialogOverride.h"
+#else
+#include <sys/stat.h>
+#include <utime.h>
 #endif
 
 
@@ -19,6 +23,12 @@ void show_STEP(const std::string text);
 void show_quant(const catalogAccess::Quantity &);
 void show_string(const std::string name, const std::string val);
 void show_double(const std::string name, const double val);
+long count_diff(catalogAccess::Catalog &cat1, catalogAccess::Catalog &cat2);
+long count_quant_diff(catalogAccess::Catalog &cat1,
+                      catalogAccess::Catalog &cat2);
+bool same_file(const std::string &name1, const std::string &name2);
+std::string fits_data(const std::string &name);
+bool funpack_last(const std::string &name, const std::string &plainName);
 
 static const std::ios_base::fmtflags
              outDouble=std::ios::right|std::ios::scientific;
@@ -255,6 +265,27 @@ int main(int iargc, char * argv[]) {
   err=myCat->importDescription(strVal);
   std::cout << "* Value returned = " << err << std::endl;
 
+  std::cout << "\n* Calling: importFiles with \"3EG_test.out\" twice"
+            << std::endl;
+  {
+    catalogAccess::Catalog twoCat;
+    catNames.assign(2, strVal);
+    err=twoCat.importFiles(catNames);
+    std::cout << "* Value returned = " << err << std::endl;
+    err=twoCat.getSValue("3EG", 0, &strVal);
+    if (err > 0) show_string("3EG", strVal);
+    strVal=myPath+"/3EG_test.out";
+    std::cout << "* Calling: importFiles with at most 7 rows" << std::endl;
+    catalogAccess::Catalog sevenCat;
+    err=sevenCat.importFiles(catNames, 7);
+    std::cout << "* Value returned = " << err << std::endl;
+    err=sevenCat.getSValue("3EG", 6, &strVal);
+    if (err > 0) show_string("3EG (row 6)", strVal);
+    twoCat.getSValue("3EG", 6, &strVal);
+    if (err > 0) show_string("3EG (row 6 of all rows)", strVal);
+    strVal=myPath+"/3EG_test.out";
+  }
+
   /* changing the verbosity level up to maximum */
   catalogAccess::verbosity=4;
   std::cout << "\n* Calling: import on file \"3EG_test.out\" (with 5 rows)"
@@ -494,6 +525,22 @@ try {
   vecSize=aCat.getSValues("SRC_3EG", &catNames);
   std::cout << "* SRC_3EG vector (size=" << vecSize << ")" << std::endl;
 
+  std::cout << "\n* Calling: import on same file with tip reader" << std::endl;
+  {
+    i=catalogAccess::verbosity; // reset by Catalog constructor
+    catalogAccess::Catalog tipCat;
+    catalogAccess::verbosity=i;
+    tipCat.setTipReader(true);
+    err=tipCat.import(strVal);
+    std::cout << "* Value returned = " << err << std::endl;
+    err=tipCat.maxVal("TEST_U9", &rVal);
+    if (err > 0) show_double("TEST_U9 maximum", rVal);
+    tipCat.getNumRows(&numRows);
+    std::cout << "* Number of rows = " << numRows << std::endl;
+    std::cout << "* Cells differing from cfitsio import: "
+              << count_diff(aCat, tipCat) << std::endl;
+  }
+
   std::cout << "\n* Calling: importSelected on same file" << std::endl;
   aCat.deleteContent();
 //  aCat.selectQuantity("POS_EQ_RAJ2000", false); "VEC"
@@ -767,6 +814,872 @@ try {
   std::cout << "* Number of rows = " << numRows << std::endl;
 
 
+/****************************************************************************/
+  show_STEP("\nSTEP 8) CHECKS of READERS and WRITERS");
+  /* only errors are shown, each Catalog constructor resets verbosity */
+  catalogAccess::verbosity=0;
+
+  std::cout << "\n* Calling: import on VECTOR file \"/test_vec.fits\""
+            << std::endl;
+  {
+    catalogAccess::Catalog vecCat;
+    catalogAccess::verbosity=0;
+    strVal=myPath+"/test_vec.fits";
+    err=vecCat.import(strVal);
+    std::cout << "* Value returned = " << err << std::endl;
+    vecCat.getNumRows(&numRows);
+    std::cout << "* Number of rows = " << numRows << std::endl;
+    std::vector<double> vecVal, cutVal;
+    err=vecCat.getVecValues("FLUX", 1, &vecVal);
+    std::cout << "* FLUX in row 1 (size=" << vecVal.size() << "):";
+    for (i=0; i<(int)vecVal.size(); i++) std::cout << " " << vecVal[i];
+    std::cout << std::endl;
+
+    cutVal.assign(4, NO_SEL_CUT);
+    cutVal[0]=5.e-8;
+    err=vecCat.setLowerVecCuts("FLUX", cutVal);
+    vecCat.getNumSelRows(&numRows);
+    std::cout << "* setLowerVecCuts (FLUX[1] >= 5e-8) returned " << err
+              << ", number of SELECTED rows = " << numRows << std::endl;
+    cutVal[0]=NO_SEL_CUT;
+    cutVal[1]=1.e-6;
+    err=vecCat.setUpperVecCuts("FLUX", cutVal);
+    vecCat.getNumSelRows(&numRows);
+    std::cout << "* setUpperVecCuts (FLUX[2] <= 1e-6) returned " << err
+              << ", number of SELECTED rows = " << numRows << std::endl;
+
+    /* text export writes one column per element */
+    strVal=myPath+"/test_vec.out.txt";
+    err=vecCat.saveText(strVal, true);
+    std::cout << "* saveText returned = " << err << std::endl;
+    catalogAccess::Catalog txtCat;
+    catalogAccess::verbosity=0;
+    err=txtCat.import(strVal);
+    std::cout << "* Value returned by text import = " << err << std::endl;
+    vecCat.getNumRows(&numRows);
+    long k, nbDiff=0;
+    int  e;
+    std::ostringstream elem;
+    for (k=0; k<numRows; k++) {
+      vecCat.getVecValues("FLUX", k, &vecVal);
+      for (e=0; e<(int)vecVal.size(); e++) {
+        elem.str("");
+        elem << "FLUX[" << e+1 << "]"; // element names start at 1
+        if (txtCat.getNValue(elem.str(), k, &rVal) != 1) nbDiff++;
+        else if (vecVal[e] != vecVal[e]) nbDiff+=(rVal == rVal);
+        else nbDiff+=(rVal != vecVal[e]);
+      }
+    }
+    std::cout << "* FLUX elements identical after text round trip: "
+              << ((nbDiff || !numRows) ? "NO" : "yes") << std::endl;
+  }
+
+  std::cout << "\n* Calling: importSelected after the cached FITS file "
+            << "was replaced" << std::endl;
+  {
+    catalogAccess::Catalog cacheCat;
+    catalogAccess::verbosity=0;
+    strVal=myPath+"/cache_test.fits";
+    {
+      std::ifstream in((myPath+argString+".fits").c_str(), std::ios::binary);
+      std::ofstream out(strVal.c_str(), std::ios::binary|std::ios::trunc);
+      out << in.rdbuf();
+    }
+    err=cacheCat.importDescription(strVal);
+    std::cout << "* importDescription (50 rows file) returned " << err
+              << std::endl;
+    /* 'aCat' has now 23 rows: same table, smaller file */
+    err=aCat.saveFits(strVal, "", true);
+    std::cout << "* saveFits of 'aCat' on same file returned " << err
+              << std::endl;
+    std::string filter;
+    err=cacheCat.importSelected(filter);
+    cacheCat.getNumRows(&numRows);
+    std::cout << "* Value returned = " << err << ", number of rows = "
+              << numRows << std::endl;
+  }
+
+  std::cout << "\n* Calling: import on file \"test_int.fits\" (integer"
+            << " columns with TSCAL, TZERO, TNULL) with cfitsio and tip"
+            << std::endl;
+  {
+    catalogAccess::Catalog intCat, tipCat;
+    catalogAccess::verbosity=0;
+    strVal=myPath+"/test_int.fits";
+    err=intCat.import(strVal);
+    std::cout << "* Value returned = " << err << std::endl;
+    tipCat.setTipReader(true);
+    err=tipCat.import(strVal);
+    std::cout << "* Value returned with tip reader = " << err << std::endl;
+    std::cout << "* Cells differing from cfitsio import: "
+              << count_diff(intCat, tipCat) << std::endl;
+    const char *intNames[]={"B8", "I16", "U16", "J32", "K64"};
+    std::vector<double> vecVal;
+    long k;
+    for (k=0; k<2; k++) {
+      std::cout << "* Row " << k << ":" << std::endl;
+      for (i=0; i<5; i++) {
+        if (intCat.getNValue(intNames[i], k, &rVal) > 0)
+          show_double(intNames[i], rVal);
+      }
+      intCat.getVecValues("V3I", k, &vecVal);
+      for (i=0; i<(int)vecVal.size(); i++) show_double("V3I", vecVal[i]);
+    }
+  }
+
+
+  std::cout << "\n* Calling: import on text file with numbers of 71 and 69"
+            << " characters" << std::endl;
+  {
+    catalogAccess::Catalog longCat;
+    catalogAccess::verbosity=0;
+    strVal=myPath+"/long_cell.txt";
+    {
+      std::ofstream out(strVal.c_str(), std::ios::trunc);
+      out << "#RESOURCE=catalogAccess()\n#Name: \n#Title:\t\n"
+          << "#Name: LONG\n#Title:\tlong cells\n"
+          << "#Column\tNAME\t(A5)\tname\t[ucd=]\n"
+          << "#Column\tVALUE\t(E80.70)\tvalue\t[ucd=]\n\n"
+          << "NAME;VALUE\n;\n---\n"
+          << "tiny;0." << std::string(62, '0') << "1234567\n"
+          << "big;1." << std::string(64, '0') << "1e5\n";
+    }
+    err=longCat.import(strVal);
+    std::cout << "* Value returned = " << err << std::endl;
+    for (numRows=0; numRows<2; numRows++) {
+      if (longCat.getNValue("VALUE", numRows, &rVal) > 0)
+        show_double("VALUE", rVal);
+    }
+  }
+
+  std::cout << "\n* Calling: import on 2.6 MB text file with 1 then 4 threads"
+            << " (2 wrong lines)" << std::endl;
+  {
+    strVal=myPath+"/big_text.txt";
+    {
+      std::ofstream out(strVal.c_str(), std::ios::trunc);
+      out << "#RESOURCE=catalogAccess()\n#Name: \n#Title:\t\n"
+          << "#Name: BIG\n#Title:\tlarge text\n"
+          << "#Column\tNAME\t(A8)\tname\t[ucd=]\n"
+          << "#Column\tX\t(F10.1)\tx\t[ucd=]\n"
+          << "#Column\tY\t(I4)\ty\t[ucd=]\n\n"
+          << "NAME;X;Y\n;;\n---\n";
+      for (long k=0; k<100000; k++) {
+        if (k == 30000) out << "s" << k << ";1\n";
+        else if (k == 90000) out << "s" << k << ";1;2;3\n";
+        else out << "s" << k << ";" << k*0.5 << "e0;" << k%97
+                 << "        \n";
+      }
+    }
+    catalogAccess::Catalog oneCat, fourCat;
+    catalogAccess::verbosity=1;
+    oneCat.setTextThreads(1);
+    err=oneCat.import(strVal);
+    std::cout << "* Value returned with 1 thread = " << err << std::endl;
+    fourCat.setTextThreads(4);
+    err=fourCat.import(strVal);
+    std::cout << "* Value returned with 4 threads = " << err << std::endl;
+    std::cout << "* Cells differing between both imports: "
+              << count_diff(oneCat, fourCat) << std::endl;
+    catalogAccess::verbosity=0;
+  }
+
+  std::cout << "\n* Calling: import on \"1rxs_50.out\" compressed by gzip"
+            << " and bzip2" << std::endl;
+  {
+    catalogAccess::Catalog txtCat, gzCat, bzCat;
+    catalogAccess::verbosity=0;
+    err=txtCat.import(myPath+"/1rxs_50.out");
+    std::cout << "* Value returned = " << err << std::endl;
+    err=gzCat.import(myPath+"/1rxs_50.out.gz");
+    std::cout << "* Value returned for .gz = " << err
+              << ", cells differing: " << count_diff(txtCat, gzCat)
+              << std::endl;
+    err=bzCat.import(myPath+"/1rxs_50.out.bz2");
+    std::cout << "* Value returned for .bz2 = " << err
+              << ", cells differing: " << count_diff(txtCat, bzCat)
+              << std::endl;
+  }
+
+  std::cout << "\n* Calling: importSelected (rows rejected while reading)"
+            << " and import then eraseNonSelected, with the same criteria"
+            << std::endl;
+  for (i=0; i<2; i++) {
+    catalogAccess::Catalog selCat, allCat;
+    catalogAccess::verbosity=0;
+    std::string filter;
+    strVal= (i) ? myPath+"/big_text.txt" : myPath+"/1rxs_50.out";
+    selCat.setTextThreads(4);
+    allCat.setTextThreads(4);
+    selCat.importDescription(strVal);
+    allCat.import(strVal);
+    if (i) {
+      selCat.setUpperCut("X", 20000.);
+      selCat.setLowerCut("Y", 50.);
+      allCat.setUpperCut("X", 20000.);
+      allCat.setLowerCut("Y", 50.);
+    }
+    else {
+      selCat.setSelEllipse(0, 90., 90, 90);
+      selCat.setUpperCut("Count", 0.1);
+      allCat.setSelEllipse(0, 90., 90, 90);
+      allCat.setUpperCut("Count", 0.1);
+    }
+    err=selCat.importSelected(filter);
+    allCat.eraseNonSelected();
+    allCat.getNumRows(&numRows);
+    std::cout << "* " << strVal.substr(myPath.length()+1) << ": "
+              << err << " and " << numRows << " rows, cells differing: "
+              << count_diff(selCat, allCat) << std::endl;
+  }
+
+#ifndef WIN32
+  std::cout << "\n* Calling: importSelected with the text index of the same"
+            << " file written with ; instead of TAB" << std::endl;
+  {
+    catalogAccess::Catalog idxCat, selCat;
+    catalogAccess::verbosity=0;
+    strVal=myPath+"/index_test.txt";
+    std::string text="#RESOURCE=catalogAccess()\n#Name: \n#Title:\t\n"
+                     "#Name: INDEX\n#Title:\tindex test\n"
+                     "#Column\tNAME\t(A4)\tname\t[ucd=]\n"
+                     "#Column\tX\t(I2)\tx\t[ucd=]\n\nNAME;X\n;\n---\n";
+    std::ostringstream rows;
+    for (i=0; i<20; i++) rows << "s" << i << ";" << i << "\n";
+    text+=rows.str();
+    {
+      std::ofstream out(strVal.c_str(), std::ios::trunc);
+      out << text;
+    }
+    idxCat.setTextIndex(4);
+    err=idxCat.import(strVal);
+    std::cout << "* Value returned = " << err << std::endl;
+    /* same size and date: only the separator tells the index is wrong */
+    struct stat info;
+    stat(strVal.c_str(), &info);
+    std::replace(text.begin()+text.find("\n\n"), text.end(), ';', '\t');
+    {
+      std::ofstream out(strVal.c_str(), std::ios::trunc);
+      out << text;
+    }
+    struct utimbuf times;
+    times.actime=info.st_atime;
+    times.modtime=info.st_mtime;
+    utime(strVal.c_str(), &times);
+    std::string filter;
+    selCat.setTextIndex(4);
+    selCat.importDescription(strVal);
+    selCat.setLowerCut("X", 10.);
+    err=selCat.importSelected(filter);
+    std::cout << "* Value returned = " << err << std::endl;
+    long head[7]={0, 0, 0, 0, 0, 0, 0};
+    std::ifstream in((strVal+".cidx").c_str(), std::ios::binary);
+    in.seekg(8);
+    in.read((char *)head, sizeof(head));
+    std::cout << "* separator of the index written again = " << head[5]
+              << std::endl;
+  }
+#endif
+
+  std::cout << "\n* Calling: importAsync on 2.6 MB text file, then copy by"
+            << " assignment" << std::endl;
+  {
+    catalogAccess::Catalog asyncCat, syncCat, copyCat;
+    catalogAccess::verbosity=0;
+    strVal=myPath+"/big_text.txt";
+    long calls=0;
+    std::future<int> result=asyncCat.importAsync(strVal, 0, "1",
+                                       [&calls](long, long) { calls++; });
+    err=result.get();
+    std::cout << "* Value returned = " << err << ", progress reported: "
+              << ((calls > 0) ? "yes" : "no") << std::endl;
+    syncCat.import(strVal);
+    copyCat=asyncCat;
+    std::cout << "* Cells differing from import: "
+              << count_diff(syncCat, asyncCat) << ", in copy: "
+              << count_diff(syncCat, copyCat) << std::endl;
+  }
+
+  std::cout << "\n* Calling: cancelImport at first progress of importAsync"
+            << std::endl;
+  {
+    catalogAccess::Catalog asyncCat;
+    catalogAccess::verbosity=0;
+    std::future<int> result=asyncCat.importAsync(strVal, 0, "1",
+                         [&asyncCat](long, long) { asyncCat.cancelImport(); });
+    err=result.get();
+    asyncCat.getNumRows(&numRows);
+    std::cout << "* Value returned = " << err << ", number of rows = "
+              << numRows << std::endl;
+  }
+
+  std::cout << "\n* Comparing saveText and saveSelectedText outputs with"
+            << " \"outref" << argString << ".txt\"" << std::endl;
+  {
+    const std::string ref=myPath+"/outref"+argString+".txt";
+    std::cout << "* saveText output of STEP 7 identical: "
+              << (same_file(myPath+argString+".txt", ref) ? "yes" : "NO")
+              << std::endl;
+    /* same catalog imported from reference, then saved again */
+    catalogAccess::Catalog txtCat;
+    catalogAccess::verbosity=0;
+    err=txtCat.import(ref);
+    std::cout << "* Value returned by import of reference = " << err
+              << std::endl;
+    strVal=myPath+argString+".again.txt";
+    err=txtCat.saveText(strVal, true);
+    std::cout << "* saveText returned " << err << ", identical: "
+              << (same_file(strVal, ref) ? "yes" : "NO") << std::endl;
+    txtCat.setLowerCut("recno", 0.);  // all rows selected
+    txtCat.getNumSelRows(&numRows);
+    strVal=myPath+argString+".sel.txt";
+    err=txtCat.saveSelectedText(strVal, true);
+    std::cout << "* saveSelectedText (" << numRows << " selected rows) "
+              << "returned " << err << ", identical: "
+              << (same_file(strVal, ref) ? "yes" : "NO") << std::endl;
+  }
+
+  std::cout << "\n* Comparing data of FITS files written by cfitsio and tip"
+            << " with \"outref" << argString << ".fits\"" << std::endl;
+  {
+    const std::string ref=fits_data(myPath+"/outref"+argString+".fits");
+    std::cout << "* saveFits output of STEP 7 identical: "
+              << ((fits_data(myPath+argString+".fits") == ref) ? "yes" : "NO")
+              << std::endl;
+    catalogAccess::Catalog fitsCat;
+    catalogAccess::verbosity=0;
+    err=fitsCat.import(myPath+argString);
+    std::cout << "* Value returned by import = " << err << std::endl;
+    strVal=myPath+argString+".blk.fits";
+    err=fitsCat.saveFits(strVal, "", true);
+    std::cout << "* saveFits returned " << err << ", identical: "
+              << ((fits_data(strVal) == ref) ? "yes" : "NO") << std::endl;
+    fitsCat.setLowerCut("recno", 0.);  // all rows selected
+    fitsCat.getNumSelRows(&numRows);
+    strVal=myPath+argString+".sel.fits";
+    err=fitsCat.saveSelectedFits(strVal, "", true);
+    std::cout << "* saveSelectedFits (" << numRows << " selected rows) "
+              << "returned " << err << ", identical: "
+              << ((fits_data(strVal) == ref) ? "yes" : "NO") << std::endl;
+    fitsCat.setTipReader(true);
+    strVal=myPath+argString+".tip.fits";
+    err=fitsCat.saveFits(strVal, "", true);
+    std::cout << "* saveFits with tip returned " << err << ", identical: "
+              << ((fits_data(strVal) == ref) ? "yes" : "NO") << std::endl;
+
+    /* NaN written as TNULL of rescaled integer columns */
+    catalogAccess::Catalog intCat, selCat;
+    catalogAccess::verbosity=0;
+    err=intCat.import(myPath+"/test_int.fits");
+    std::cout << "* Value returned by import of \"test_int.fits\" = " << err
+              << std::endl;
+    intCat.setRejectNaN("J32", false);
+    intCat.setUpperCut("J32", 1.e9);
+    intCat.getNumSelRows(&numRows);
+    strVal=myPath+"/test_int.sel.fits";
+    err=intCat.saveSelectedFits(strVal, "", true);
+    std::cout << "* saveSelectedFits (" << numRows << " selected rows) "
+              << "returned " << err << std::endl;
+    const std::string intData=fits_data(strVal);
+    intCat.setTipReader(true);
+    strVal=myPath+"/test_int.tip.fits";
+    err=intCat.saveSelectedFits(strVal, "", true);
+    std::cout << "* saveSelectedFits with tip returned " << err
+              << ", identical: "
+              << (((!intData.empty()) && (fits_data(strVal) == intData))
+                  ? "yes" : "NO") << std::endl;
+    err=selCat.import(myPath+"/test_int.sel.fits");
+    intCat.eraseNonSelected();
+    std::cout << "* Value returned by import = " << err
+              << ", cells differing from selected rows: "
+              << count_diff(intCat, selCat) << std::endl;
+    if (selCat.getNValue("B8", 1, &rVal) > 0) show_double("B8 of row 1", rVal);
+  }
+
+  std::cout << "\n* Calling: saveText and saveSelectedText of 2.6 MB text"
+            << " file with 1 then 4 threads" << std::endl;
+  {
+    catalogAccess::Catalog bigCat;
+    catalogAccess::verbosity=0;
+    bigCat.setTextThreads(4);
+    err=bigCat.import(myPath+"/big_text.txt");
+    std::cout << "* Value returned by import = " << err << std::endl;
+    const std::string oneName=myPath+"/big_text.1.txt",
+                      fourName=myPath+"/big_text.4.txt";
+    for (i=0; i<2; i++) {
+      if (i) {
+        bigCat.setUpperCut("X", 20000.);
+        bigCat.getNumSelRows(&numRows);
+        std::cout << "* Selected rows: " << numRows << std::endl;
+      }
+      bigCat.setTextThreads(1);
+      const int oneErr= (i) ? bigCat.saveSelectedText(oneName, true)
+                            : bigCat.saveText(oneName, true);
+      bigCat.setTextThreads(4);
+      err= (i) ? bigCat.saveSelectedText(fourName, true)
+               : bigCat.saveText(fourName, true);
+      std::cout << "* " << ((i) ? "saveSelectedText" : "saveText")
+                << " returned " << oneErr << " then " << err
+                << ", identical: "
+                << (same_file(oneName, fourName) ? "yes" : "NO") << std::endl;
+    }
+  }
+
+  std::cout << "\n* Calling: saveText to \".gz\" and saveFits to \".fz\","
+            << " then import again" << std::endl;
+  {
+    catalogAccess::Catalog txtCat, gzCat, bigCat, bigTxtCat, bigGzCat;
+    catalogAccess::verbosity=0;
+    const std::string ref=myPath+"/outref"+argString+".txt";
+    txtCat.import(ref);
+    strVal=myPath+argString+".txt.gz";
+    err=txtCat.saveText(strVal, true);
+    std::cout << "* saveText returned " << err << std::endl;
+    err=gzCat.import(strVal);
+    std::cout << "* Value returned by import = " << err
+              << ", cells differing: " << count_diff(txtCat, gzCat)
+              << std::endl;
+    strVal=myPath+argString+".gz.txt";
+    gzCat.saveText(strVal, true);
+    std::cout << "* saved again without gzip, identical to reference: "
+              << (same_file(strVal, ref) ? "yes" : "NO") << std::endl;
+    /* strings are read back right aligned: compared to plain text */
+    bigCat.setTextThreads(4);
+    bigCat.import(myPath+"/big_text.txt");
+    strVal=myPath+"/big_text.out.gz";
+    err=bigCat.saveText(strVal, true);
+    bigCat.saveText(myPath+"/big_text.out.txt", true);
+    std::cout << "* saveText of \"big_text.txt\" returned " << err
+              << std::endl;
+    bigTxtCat.import(myPath+"/big_text.out.txt");
+    err=bigGzCat.import(strVal);
+    std::cout << "* Value returned by import = " << err
+              << ", cells differing from plain text: "
+              << count_diff(bigTxtCat, bigGzCat) << std::endl;
+
+    /* tile compressed table is not imported: unpacked as by funpack */
+    catalogAccess::Catalog fitsCat, fzCat;
+    catalogAccess::verbosity=0;
+    fitsCat.import(myPath+argString);
+    strVal=myPath+argString+".fz";
+    err=fitsCat.saveFits(strVal, "", true);
+    std::cout << "* saveFits returned " << err << ", unpacked data identical"
+              << " to \"outref" << argString << ".fits\": "
+              << (((funpack_last(strVal, strVal+".fits"))
+                   && (fits_data(strVal+".fits")
+                       == fits_data(myPath+"/outref"+argString+".fits")))
+                  ? "yes" : "NO") << std::endl;
+    fitsCat.setSelEllipse(0, 90., 90, 90);
+    fitsCat.getNumSelRows(&numRows);
+    err=fitsCat.saveSelectedFits(strVal, "", true);
+    std::cout << "* saveSelectedFits (" << numRows << " selected rows) "
+              << "returned " << err << std::endl;
+    fitsCat.saveSelectedFits(myPath+argString+".ell.fits", "", true);
+    err= (funpack_last(strVal, strVal+".fits")) ? fzCat.import(strVal+".fits")
+                                                : 0;
+    const std::string ellData=fits_data(myPath+argString+".ell.fits");
+    std::cout << "* Value returned by import of unpacked file = " << err
+              << ", data identical to uncompressed saveSelectedFits: "
+              << (((!ellData.empty()) && (fits_data(strVal+".fits") == ellData))
+                  ? "yes" : "NO") << std::endl;
+  }
+
+  std::cout << "\n* Calling: saveSnapshot then loadSnapshot without and with"
+            << " selection" << std::endl;
+  {
+    catalogAccess::Catalog srcCat;
+    catalogAccess::verbosity=0;
+    srcCat.import(myPath+argString);
+    strVal=myPath+argString+".snap";
+    for (i=0; i<2; i++) {
+      if (i) {
+        listVal.assign(2, 1.0);
+        srcCat.setSelEllipse(0, 90., 90, 90);
+        srcCat.setUpperCut("Count", 0.1);
+        srcCat.setRejectNaN("L_Extent", false);
+        srcCat.excludeN("L_Extent", listVal);
+      }
+      catalogAccess::Catalog snapCat;
+      catalogAccess::verbosity=0;
+      err=srcCat.saveSnapshot(strVal, true, i);
+      std::cout << "* saveSnapshot" << ((i) ? " with selection" : "")
+                << " returned " << err << std::endl;
+      err=snapCat.loadSnapshot(strVal);
+      long selRows=0, nbDiff=0, k;
+      srcCat.getNumSelRows(&numRows);
+      snapCat.getNumSelRows(&selRows);
+      for (k=0; k<numRows; k++) {
+        double rVal2=0.;
+        if ((srcCat.getSelNValue("recno", k, &rVal) != 1)
+            || (snapCat.getSelNValue("recno", k, &rVal2) != 1)
+            || (rVal != rVal2)) nbDiff++;
+      }
+      std::cout << "* Value returned by loadSnapshot = " << err
+                << ", cells differing: " << count_diff(srcCat, snapCat)
+                << ", quantities differing: "
+                << count_quant_diff(srcCat, snapCat) << std::endl;
+      std::cout << "* Generic quantities identical: "
+                << (((srcCat.getNameRA() == snapCat.getNameRA())
+                     && (srcCat.getNameDEC() == snapCat.getNameDEC())
+                     && (srcCat.getNamePosErr() == snapCat.getNamePosErr())
+                     && (srcCat.getNameL() == snapCat.getNameL())
+                     && (srcCat.getNameB() == snapCat.getNameB())
+                     && (srcCat.getNameObjName() == snapCat.getNameObjName())
+                     && (!snapCat.getNameRA().empty())) ? "yes" : "NO")
+                << ", selected rows: " << selRows << " (" << numRows
+                << " saved, " << nbDiff << " differing)" << std::endl;
+    }
+    /* same file without its last bytes, then with only its first ones */
+    std::ifstream in(strVal.c_str(), std::ios::binary);
+    std::ostringstream text;
+    text << in.rdbuf();
+    const std::string snap=text.str(), cutName=myPath+"/cut.snap";
+    for (i=0; i<2; i++) {
+      {
+        std::ofstream out(cutName.c_str(), std::ios::binary|std::ios::trunc);
+        out << snap.substr(0, (i) ? 40 : snap.size()-8);
+      }
+      catalogAccess::Catalog cutCat;
+      catalogAccess::verbosity=0;
+      err=cutCat.loadSnapshot(cutName);
+      cutCat.getNumRows(&numRows);
+      std::cout << "* loadSnapshot of file truncated to "
+                << ((i) ? "40 bytes" : "size-8 bytes") << " returned " << err
+                << ", number of rows = " << numRows << std::endl;
+    }
+  }
+
+  std::cout << "\n* Calling: appendFits of \"" << argString.substr(1)
+            << "\" to a copy of \"" << argString.substr(1) << ".fits\""
+            << std::endl;
+  {
+    catalogAccess::Catalog txtCat, outCat, twiceCat, intCat;
+    catalogAccess::verbosity=0;
+    strVal=myPath+"/append_test.fits";
+    {
+      std::ifstream in((myPath+argString+".fits").c_str(), std::ios::binary);
+      std::ofstream out(strVal.c_str(), std::ios::binary|std::ios::trunc);
+      out << in.rdbuf();
+    }
+    txtCat.import(myPath+argString);
+    err=txtCat.appendFits(strVal);
+    std::cout << "* appendFits returned " << err << std::endl;
+    outCat.import(myPath+argString+".fits");
+    err=twiceCat.import(strVal);
+    /* row k and k+50 of appended file are row k of saved file */
+    std::vector<catalogAccess::Quantity> quants;
+    outCat.getQuantityDescription(&quants);
+    outCat.getNumRows(&numRows);
+    long k, nbDiff= ((numRows > 0) && (err == 2*numRows)) ? 0 : -1;
+    double rVal2;
+    std::string sVal, sVal2;
+    for (i=0; (nbDiff >= 0) && (i<(int)quants.size()); i++) {
+      const std::string &name=quants[i].m_name;
+      for (k=0; k<2*numRows; k++) {
+        if (quants[i].m_type == catalogAccess::Quantity::NUM) {
+          outCat.getNValue(name, k%numRows, &rVal);
+          twiceCat.getNValue(name, k, &rVal2);
+          if ((rVal != rVal2) && ((rVal == rVal) || (rVal2 == rVal2)))
+            nbDiff++;
+        }
+        else if (quants[i].m_type == catalogAccess::Quantity::STRING) {
+          outCat.getSValue(name, k%numRows, &sVal);
+          twiceCat.getSValue(name, k, &sVal2);
+          if (sVal != sVal2) nbDiff++;
+        }
+      }
+    }
+    std::cout << "* Value returned by import = " << err << ", cells differing"
+              << " from the " << numRows << " saved rows (twice): " << nbDiff
+              << std::endl;
+    /* other columns: nothing written */
+    std::ifstream in(strVal.c_str(), std::ios::binary);
+    std::ostringstream text;
+    text << in.rdbuf();
+    const std::string before=text.str();
+    in.close();
+    intCat.import(myPath+"/test_int.fits");
+    err=intCat.appendFits(strVal);
+    in.open(strVal.c_str(), std::ios::binary);
+    text.str("");
+    text << in.rdbuf();
+    std::cout << "* appendFits of \"test_int.fits\" returned " << err
+              << ", file unchanged: "
+              << (((!before.empty()) && (text.str() == before)) ? "yes" : "NO")
+              << std::endl;
+  }
+
+  std::cout << "\n* Calling: saveText, saveSelectedText and saveFits of"
+            << " 3 quantities (Count, 1RXS, RAJ2000)" << std::endl;
+  {
+    catalogAccess::Catalog srcCat;
+    catalogAccess::verbosity=0;
+    srcCat.import(myPath+argString);
+    srcCat.setSelEllipse(0, 90., 90, 90);
+    std::vector<std::string> names;
+    names.push_back("Count");
+    names.push_back("1RXS");
+    names.push_back("RAJ2000");
+    const std::string fileNames[3]={myPath+argString+".proj.txt",
+                                    myPath+argString+".psel.txt",
+                                    myPath+argString+".proj.fits"};
+    for (i=0; i<3; i++) {
+      catalogAccess::Catalog projCat;
+      catalogAccess::verbosity=0;
+      int saveErr;
+      if (i == 0) saveErr=srcCat.saveText(fileNames[i], names, true);
+      else if (i == 1)
+        saveErr=srcCat.saveSelectedText(fileNames[i], names, true);
+      else saveErr=srcCat.saveFits(fileNames[i], "", names, true);
+      err=projCat.import(fileNames[i]);
+      std::vector<std::string> projNames;
+      projCat.getQuantityNames(&projNames);
+      /* same values as the saved (or selected) rows of srcCat */
+      long k, nbDiff= (projNames == names) ? 0 : -1;
+      double rVal2;
+      std::string sVal, sVal2;
+      for (k=0; (nbDiff >= 0) && (k<err); k++) {
+        if (i == 1) {
+          srcCat.getSelNValue("Count", k, &rVal);
+          srcCat.getSelSValue("1RXS", k, &sVal);
+        }
+        else {
+          srcCat.getNValue("Count", k, &rVal);
+          srcCat.getSValue("1RXS", k, &sVal);
+        }
+        projCat.getNValue("Count", k, &rVal2);
+        projCat.getSValue("1RXS", k, &sVal2);
+        if ((rVal != rVal2) || (sVal != sVal2)) nbDiff++;
+        if (i == 1) srcCat.getSelNValue("RAJ2000", k, &rVal);
+        else srcCat.getNValue("RAJ2000", k, &rVal);
+        projCat.getNValue("RAJ2000", k, &rVal2);
+        if (rVal != rVal2) nbDiff++;
+      }
+      std::cout << "* " << ((i == 0) ? "saveText" : (i == 1)
+                            ? "saveSelectedText" : "saveFits")
+                << " returned " << saveErr << ", imported rows: " << err
+                << ", cells differing: " << nbDiff << std::endl;
+    }
+    names.push_back("NO_SUCH_NAME");
+    strVal=myPath+"/no_such.txt";
+    remove(strVal.c_str());
+    err=srcCat.saveText(strVal, names, true);
+    std::ifstream in(strVal.c_str());
+    std::cout << "* saveText with unknown name returned " << err
+              << ", file created: " << ((in.is_open()) ? "yes" : "no")
+              << std::endl;
+    err=srcCat.saveFits(myPath+"/no_such.fits", "", names, true);
+    std::cout << "* saveFits with unknown name returned " << err << std::endl;
+    names.back()="Count";
+    err=srcCat.saveSelectedText(strVal, names, true);
+    std::cout << "* saveSelectedText with name given twice returned " << err
+              << std::endl;
+  }
+
+  std::cout << "\n* Calling: saveFits with selection, then import"
+            << std::endl;
+  {
+    catalogAccess::Catalog srcCat, selCat;
+    catalogAccess::verbosity=0;
+    srcCat.import(myPath+argString);
+    listVal.assign(2, 1.0);
+    listVal.at(1)=catalogAccess::MissNAN;
+    srcCat.setSelEllipse(0, 90., 90, 90);
+    srcCat.setUpperCut("Count", 0.1);
+    srcCat.setRejectNaN("L_Extent", false);
+    srcCat.excludeN("L_Extent", listVal);
+    srcCat.setFitsSelection(true);
+    strVal=myPath+"/sel_test.fits";
+    err=srcCat.saveFits(strVal, "", true);
+    std::cout << "* saveFits returned " << err << std::endl;
+    err=selCat.import(strVal);
+    std::vector<std::string> names;
+    selCat.getQuantityNames(&names);
+    std::cout << "* Value returned by import = " << err << ", quantities: "
+              << names.size() << ", SELBITS imported: "
+              << ((std::find(names.begin(), names.end(), "SELBITS")
+                   != names.end()) ? "yes" : "no") << std::endl;
+    /* criteria of each quantity, then selected rows */
+    std::vector<catalogAccess::Quantity> q1, q2;
+    srcCat.getQuantityDescription(&q1);
+    selCat.getQuantityDescription(&q2);
+    long k, nbDiff= (q1.size() == q2.size()) ? 0 : -1;
+    for (k=0; (nbDiff >= 0) && (k<(long)q1.size()); k++) {
+      const catalogAccess::Quantity &a=q1[k], &b=q2[k];
+      if ((a.m_name != b.m_name) || (a.m_listValS != b.m_listValS)
+          || (a.m_lowerCut != b.m_lowerCut) || (a.m_upperCut != b.m_upperCut)
+          || (a.m_excludeList != b.m_excludeList)
+          || (a.m_precision != b.m_precision)
+          || (a.m_rejectNaN != b.m_rejectNaN) || (a.m_cutORed != b.m_cutORed)
+          || (a.m_listValN.size() != b.m_listValN.size())) nbDiff++;
+      else for (i=0; i<(int)a.m_listValN.size(); i++) {
+        rVal=a.m_listValN[i];
+        if ((rVal != b.m_listValN[i])
+            && ((rVal == rVal) || (b.m_listValN[i] == b.m_listValN[i]))) {
+          nbDiff++;
+          break;
+        }
+      }
+    }
+    std::cout << "* Quantities with different criteria: " << nbDiff
+              << std::endl;
+    /* region and bits restored: same rows after removing one criterion */
+    for (i=0; i<2; i++) {
+      if (i) {
+        srcCat.unsetCuts("Count");
+        selCat.unsetCuts("Count");
+        std::cout << "* Calling: unsetCuts (on Count)" << std::endl;
+      }
+      long selRows=0;
+      double rVal2=0.;
+      srcCat.getNumSelRows(&numRows);
+      selCat.getNumSelRows(&selRows);
+      for (nbDiff=0, k=0; k<numRows; k++) {
+        if ((srcCat.getSelNValue("recno", k, &rVal) != 1)
+            || (selCat.getSelNValue("recno", k, &rVal2) != 1)
+            || (rVal != rVal2)) nbDiff++;
+      }
+      std::cout << "* Number of SELECTED rows = " << selRows << " ("
+                << numRows << " saved, " << nbDiff << " differing)"
+                << std::endl;
+    }
+  }
+
+  std::cout << "\n* Calling: saveVOTable and saveSelectedVOTable, then import"
+            << std::endl;
+  {
+    const std::string inNames[3]={myPath+argString, myPath+"/big_text.txt",
+                                  myPath+"/test_vec.fits"};
+    for (i=0; i<4; i++) {
+      catalogAccess::Catalog srcCat, votCat;
+      catalogAccess::verbosity=0;
+      srcCat.setTextThreads(4);
+      srcCat.import(inNames[i%3]);
+      strVal=myPath+"/vot_test.xml";
+      if (i == 3) {
+        srcCat.setSelEllipse(0, 90., 90, 90);
+        err=srcCat.saveSelectedVOTable(strVal, true);
+        srcCat.eraseNonSelected();
+      }
+      else err=srcCat.saveVOTable(strVal, true);
+      std::cout << "* " << ((i == 3) ? "saveSelectedVOTable" : "saveVOTable")
+                << " of \"" << inNames[i%3].substr(myPath.size()+1)
+                << "\" returned " << err << std::endl;
+      /* NaN, empty strings and last base64 line of the stream */
+      std::vector<catalogAccess::Quantity> quants;
+      srcCat.getQuantityDescription(&quants);
+      srcCat.getNumRows(&numRows);
+      long k, nbNaN=0, nbEmpty=0, nbVec=0;
+      std::string sVal;
+      std::vector<double> vecVal;
+      for (size_t q=0; q<quants.size(); q++) for (k=0; k<numRows; k++) {
+        const std::string &name=quants[q].m_name;
+        if (quants[q].m_type == catalogAccess::Quantity::NUM) {
+          srcCat.getNValue(name, k, &rVal);
+          nbNaN+=(rVal != rVal);
+        }
+        else if (quants[q].m_type == catalogAccess::Quantity::STRING) {
+          srcCat.getSValue(name, k, &sVal);
+          nbEmpty+=sVal.empty();
+        }
+        else if (quants[q].m_type == catalogAccess::Quantity::VECTOR) {
+          srcCat.getVecValues(name, k, &vecVal);
+          nbVec+=vecVal.size();
+          for (size_t e=0; e<vecVal.size(); e++)
+            nbNaN+=(vecVal[e] != vecVal[e]);
+        }
+      }
+      std::ifstream in(strVal.c_str(), std::ios::binary);
+      std::ostringstream text;
+      text << in.rdbuf();
+      const std::string xml=text.str();
+      std::string::size_type end=xml.find("</STREAM>"),
+                             pos=xml.rfind('\n', end-2);
+      std::cout << "* " << numRows << " rows, NaN values: " << nbNaN
+                << ", empty strings: " << nbEmpty << ", vector elements: "
+                << nbVec << ", last base64 line: "
+                << ((end == std::string::npos) ? 0 : end-pos-2)
+                << " characters" << std::endl;
+      err=votCat.import(strVal);
+      std::cout << "* Value returned by import = " << err
+                << ", cells differing: " << count_diff(srcCat, votCat)
+                << std::endl;
+    }
+  }
+
+  std::cout << "\n* Calling: saveSelectedText, saveSelectedVOTable and"
+            << " saveSelectedFits of the 6 last rows of 100000" << std::endl;
+  {
+    catalogAccess::Catalog bigCat;
+    catalogAccess::verbosity=0;
+    bigCat.setTextThreads(4);
+    bigCat.import(myPath+"/big_text.txt");
+    bigCat.setLowerCut("X", 49997.);
+    bigCat.getNumSelRows(&numRows);
+    std::cout << "* Number of SELECTED rows = " << numRows << std::endl;
+    /* references written before rows were visited from their index */
+    strVal=myPath+"/big_text.sel.txt";
+    err=bigCat.saveSelectedText(strVal, true);
+    std::cout << "* saveSelectedText returned " << err << ", identical to"
+              << " \"outref/big_text.sel.txt\": "
+              << (same_file(strVal, myPath+"/outref/big_text.sel.txt")
+                  ? "yes" : "NO") << std::endl;
+    strVal=myPath+"/big_text.sel.xml";
+    err=bigCat.saveSelectedVOTable(strVal, true);
+    std::cout << "* saveSelectedVOTable returned " << err << ", identical to"
+              << " \"outref/big_text.sel.xml\": "
+              << (same_file(strVal, myPath+"/outref/big_text.sel.xml")
+                  ? "yes" : "NO") << std::endl;
+    strVal=myPath+"/big_text.sel.fits";
+    err=bigCat.saveSelectedFits(strVal, "", true);
+    const std::string selData=fits_data(strVal);
+    bigCat.eraseNonSelected();
+    strVal=myPath+"/big_text.erase.fits";
+    bigCat.saveFits(strVal, "", true);
+    std::cout << "* saveSelectedFits returned " << err << ", data identical"
+              << " to saveFits after eraseNonSelected: "
+              << (((!selData.empty()) && (fits_data(strVal) == selData))
+                  ? "yes" : "NO") << std::endl;
+  }
+
+  std::cout << "\n* Calling: importSelected on \"test_int.fits\" with cuts"
+            << " on rescaled columns" << std::endl;
+  for (i=0; i<2; i++) {
+    catalogAccess::Catalog selCat, allCat;
+    catalogAccess::verbosity=0;
+    std::string filter;
+    strVal=myPath+"/test_int.fits";
+    selCat.importDescription(strVal);
+    allCat.import(strVal);
+    /* physical values: raw integers would give no row, then 2 rows */
+    const std::string name= (i) ? "I16" : "U16";
+    const std::string cut= (i) ? "100" : "32800";
+    selCat.setLowerCut(name, std::atof(cut.c_str()));
+    allCat.setLowerCut(name, std::atof(cut.c_str()));
+    err=selCat.importSelected(filter);
+    allCat.eraseNonSelected();
+    allCat.getNumRows(&numRows);
+    std::cout << "* " << name << " >= " << cut << ": " << err << " and "
+              << numRows << " rows, cells differing: "
+              << count_diff(selCat, allCat) << std::endl;
+  }
+
+  std::cout << "\n* Calling: import of 2.6 MB text file with maxRows,"
+            << " 1 then 4 threads" << std::endl;
+  for (i=0; i<2; i++) {
+    catalogAccess::Catalog oneCat, fourCat;
+    catalogAccess::verbosity=0;
+    const long maxRows= (i) ? 60000 : 100;
+    strVal=myPath+"/big_text.txt";
+    oneCat.setTextThreads(1);
+    const int oneErr=oneCat.import(strVal, maxRows);
+    fourCat.setTextThreads(4);
+    err=fourCat.import(strVal, maxRows);
+    std::cout << "* maxRows=" << maxRows << ": " << oneErr << " and " << err
+              << " rows, cells differing: " << count_diff(oneCat, fourCat)
+              << std::endl;
+  }
+
 /****************************************************************************/
   std::cout << "\n!END PROGRAM!\n(as pointers are already deleted, only free"
             << " the Quantity and Catalog copies)." << std::endl;
@@ -804,3 +1717,149 @@ void show_double(const std::string name, const double val) {
             << std::setw(11) << std::setfill(' ')
             << val << std::resetiosflags(outDouble) << std::endl;
 }
+
+/* number of cells (NaN equal to NaN) differing between two catalogs,
+   -1 if their rows or quantities differ; LOGICALS are not compared */
+long count_diff(catalogAccess::Catalog &cat1, catalogAccess::Catalog &cat2) {
+  long rows, row, nbDiff=0;
+  cat1.getNumRows(&rows);
+  cat2.getNumRows(&row);
+  if ((rows != row) || (rows == 0)) return -1;
+  std::vector<catalogAccess::Quantity> q1, q2;
+  cat1.getQuantityDescription(&q1);
+  cat2.getQuantityDescription(&q2);
+  if (q1.size() != q2.size()) return -1;
+  double r1, r2;
+  std::string s1, s2;
+  std::vector<double> v1, v2;
+  size_t j, e;
+  for (j=0; j<q1.size(); j++) {
+    const std::string &name=q1[j].m_name;
+    if ((name != q2[j].m_name) || (q1[j].m_type != q2[j].m_type)) return -1;
+    for (row=0; row<rows; row++) switch (q1[j].m_type) {
+      case catalogAccess::Quantity::NUM:
+        cat1.getNValue(name, row, &r1);
+        cat2.getNValue(name, row, &r2);
+        if ((r1 != r2) && ((r1 == r1) || (r2 == r2))) nbDiff++;
+        break;
+      case catalogAccess::Quantity::STRING:
+        cat1.getSValue(name, row, &s1);
+        cat2.getSValue(name, row, &s2);
+        if (s1 != s2) nbDiff++;
+        break;
+      case catalogAccess::Quantity::VECTOR:
+        cat1.getVecValues(name, row, &v1);
+        cat2.getVecValues(name, row, &v2);
+        if (v1.size() != v2.size()) { nbDiff++; break; }
+        for (e=0; e<v1.size(); e++)
+          if ((v1[e] != v2[e]) && ((v1[e] == v1[e]) || (v2[e] == v2[e])))
+            nbDiff++;
+        break;
+      default: break;
+    }
+  }
+  return nbDiff;
+}
+
+/* number of quantities (description and criteria) differing between
+   two catalogs, -1 if their number differ */
+long count_quant_diff(catalogAccess::Catalog &cat1,
+                      catalogAccess::Catalog &cat2) {
+  std::vector<catalogAccess::Quantity> q1, q2;
+  cat1.getQuantityDescription(&q1);
+  cat2.getQuantityDescription(&q2);
+  if (q1.size() != q2.size()) return -1;
+  long nbDiff=0;
+  for (size_t j=0; j<q1.size(); j++) {
+    const catalogAccess::Quantity &a=q1[j], &b=q2[j];
+    if ((a.m_name != b.m_name) || (a.m_comment != b.m_comment)
+        || (a.m_ucd != b.m_ucd) || (a.m_format != b.m_format)
+        || (a.m_null != b.m_null) || (a.m_type != b.m_type)
+        || (a.m_unit != b.m_unit) || (a.m_index != b.m_index)
+        || (a.m_isGeneric != b.m_isGeneric)
+        || (a.m_statError != b.m_statError) || (a.m_sysError != b.m_sysError)
+        || (a.m_vectorQs != b.m_vectorQs) || (a.m_listValS != b.m_listValS)
+        || (a.m_lowerCut != b.m_lowerCut) || (a.m_upperCut != b.m_upperCut)
+        || (a.m_listValN != b.m_listValN)
+        || (a.m_lowerVecCuts != b.m_lowerVecCuts)
+        || (a.m_upperVecCuts != b.m_upperVecCuts)
+        || (a.m_excludeList != b.m_excludeList)
+        || (a.m_precision != b.m_precision)
+        || (a.m_rejectNaN != b.m_rejectNaN) || (a.m_cutORed != b.m_cutORed))
+      nbDiff++;
+  }
+  return nbDiff;
+}
+
+/* true if both files exist and have the same bytes */
+bool same_file(const std::string &name1, const std::string &name2) {
+  std::ifstream in1(name1.c_str(), std::ios::binary),
+                in2(name2.c_str(), std::ios::binary);
+  if ((!in1.is_open()) || (!in2.is_open())) return false;
+  std::ostringstream text1, text2;
+  text1 << in1.rdbuf();
+  text2 << in2.rdbuf();
+  return (text1.str() == text2.str());
+}
+
+/* bytes of the data unit of the last HDU of a FITS file,
+   empty if the file cannot be read */
+std::string fits_data(const std::string &name) {
+  std::ifstream in(name.c_str(), std::ios::binary);
+  if (!in.is_open()) return "";
+  std::ostringstream text;
+  text << in.rdbuf();
+  const std::string file=text.str();
+  const size_t block=2880;
+  size_t pos=0, start=0, size=0;
+  while (pos+block <= file.size()) {
+    long bitpix=0, naxis=0, pcount=0, gcount=1, axis;
+    std::vector<long> naxes;
+    bool end=false;
+    for (; (!end) && (pos+block <= file.size()); pos+=block)
+      for (start=pos; start<pos+block; start+=80) {
+        const std::string key=file.substr(start, 8),
+                          val=file.substr(start+10, 70);
+        if (key == "END     ") { end=true; break; }
+        if (file.compare(start+8, 2, "= ") != 0) continue;
+        axis=atol(val.c_str());
+        if (key == "BITPIX  ") bitpix=axis;
+        else if (key == "NAXIS   ") naxis=axis;
+        else if (key == "PCOUNT  ") pcount=axis;
+        else if (key == "GCOUNT  ") gcount=axis;
+        else if (key.compare(0, 5, "NAXIS") == 0) naxes.push_back(axis);
+      }
+    if ((!end) || (naxes.size() != (size_t)naxis)) return "";
+    size=0;
+    if (naxis > 0) {
+      size=1;
+      for (axis=0; axis<naxis; axis++) size*=naxes[axis];
+    }
+    size=(size+pcount)*gcount*(bitpix < 0 ? -bitpix : bitpix)/8;
+    start=pos;
+    pos+=(size+block-1)/block*block;
+  }
+  if ((pos != file.size()) || (start+size > file.size())) return "";
+  return file.substr(start, size);
+}
+
+/* copy of a FITS file with its last HDU (tile compressed table)
+   uncompressed, as done by funpack; false if cfitsio fails */
+bool funpack_last(const std::string &name, const std::string &plainName) {
+  fitsfile *in=0, *out=0;
+  int  i, nbHdu=0, hdutype, status=0, closeStatus=0;
+  fits_open_file(&in, name.c_str(), READONLY, &status);
+  fits_get_num_hdus(in, &nbHdu, &status);
+  fits_create_file(&out, ("!"+plainName).c_str(), &status);
+  for (i=1; (i<nbHdu) && (!status); i++) {
+    fits_movabs_hdu(in, i, &hdutype, &status);
+    fits_copy_hdu(in, out, 0, &status);
+  }
+  fits_movabs_hdu(in, nbHdu, &hdutype, &status);
+  fits_uncompress_table(in, out, &status);
+  if (out) fits_close_file(out, &closeStatus);
+  if (!status) status=closeStatus;
+  closeStatus=0;
+  if (in) fits_close_file(in, &closeStatus);
+  return (status == 0);
+}